@@ -0,0 +1,284 @@
+#include "alloc_counter.h"
+#include "ansi_target.h"
+#include "frame_clock.h"
+#include "frame_profiler.h"
+#include "game_stat.h"
+#include "input_reader.h"
+#include "level.h"
+#include "link_monitor.h"
+#include "ncu.h"
+#include "notification_bar.h"
+#include "playing_field.h"
+#include "sim_input.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks that frames do not allocate memory once the game has warmed up.
+// Plays each level with the paddle following the lowest ball, through the same frame path as Game::run_round:
+// waiting on the FrameClock, reading the keys through an InputReader, Level::run_loop(), the FrameProfiler
+// (with the overlay shown, so every phase is timed and drawn) and the LinkMonitor. The keys are fed to the
+// InputReader through a pipe, as the terminal would send them, and the frames are drawn into a terminal whose
+// output is thrown away, either through ncurses or the ANSI output. The calls to operator new made by each frame
+// are counted (see alloc_counter.h), and alloc_check exits with 1 if any frame after the warm-up allocated.
+
+// The outcome of checking one level.
+struct AllocCheckResult {
+    int frames_checked = 0;
+    int allocating_frames = 0;
+    long long allocations = 0;
+    // The first frame that allocated, counted from when the level was loaded, or -1 if none did.
+    int first_allocating_frame = -1;
+};
+
+// Writes a key to the InputReader's pipe the way a terminal sends it.
+// key_fd: The end of the pipe to write to.
+// key: The key, or ERR for none.
+void feed_key(int key_fd, int key) {
+    const char *bytes;
+    char single[2] = {(char)key, '\0'};
+    switch (key) {
+    case ERR:
+        return;
+    case KEY_LEFT:
+        bytes = "\033[D";
+        break;
+    case KEY_RIGHT:
+        bytes = "\033[C";
+        break;
+    default:
+        bytes = single;
+        break;
+    }
+    if (write(key_fd, bytes, std::strlen(bytes)) < 0) {
+        return;
+    }
+}
+
+// Plays a level for a number of frames, starting it again whenever the game is over, and counts the allocations
+// made by each frame. Loading the level and starting a new round are not part of a frame, so they are not counted.
+// level_file: The address of the level file to play.
+// frames: The number of frames to play.
+// warm_up: The number of frames after the level is loaded that may allocate, e.g. to grow a pool.
+// ansi: Whether the frames are drawn with the ANSI output instead of ncurses.
+// null_out: A file that throws away what is written to it, for the ANSI output and the LinkMonitor.
+// result: Set to what was found.
+// Returns 0 if the level was played, 1 if it failed to load.
+int check_level(std::string level_file, int frames, int warm_up, bool ansi, FILE *null_out, AllocCheckResult &result) {
+    PlayingField pf = PlayingField({32.0, 32.0});
+    NotificationBar bar = NotificationBar(64, 1);
+    GameStat game_stat;
+    pf.set_display_window();
+    game_stat.set_display_window(pf.max_x, pf.max_y);
+    bar.set_display_window(pf.max_y + 6);
+    AnsiTarget ansi_target(pf.get_display_window(), null_out);
+    if (ansi) {
+        pf.set_render_target(ansi_target);
+    }
+
+    // Frames are as short as the clock allows, but still come late now and then, so some have several ticks
+    FrameClock frame_clock(1);
+    FrameProfiler profiler;
+    profiler.toggle_overlay();
+    game_stat.bind_profiler(profiler);
+
+    int key_pipe[2];
+    if (pipe(key_pipe) != 0) {
+        return 1;
+    }
+    InputReader reader(key_pipe[0]);
+    TerminalLink terminal_link(null_out);
+    terminal_link.bind_input_reader(reader);
+    LinkMonitor link_monitor(terminal_link);
+    reader.start();
+    link_monitor.reset();
+
+    Level *level = NULL;
+    TrackingInput player;
+    std::vector<int> keys;
+    keys.reserve(8);
+    bool aiming = true;
+    int frames_since_load = 0;
+    int status = 0;
+
+    for (int frame = 0; frame < frames; frame++) {
+        if (level == NULL || !game_stat.has_lives() || level->all_bricks_destroyed()) {
+            if (level != NULL) {
+                level->destroy_objects();
+                delete level;
+            }
+            game_stat.reset_all_stats();
+            level = new Level();
+            level->bind_stat(game_stat);
+            level->bind_playing_field(pf);
+            level->bind_notification_bar(bar);
+            level->bind_frame_clock(frame_clock);
+            level->bind_input_reader(reader);
+            level->bind_profiler(profiler);
+            level->set_seed(1);
+            if (level->load_level_by_file(level_file) != 0) {
+                delete level;
+                level = NULL;
+                status = 1;
+                break;
+            }
+            game_stat.add_level();
+            aiming = true;
+            frames_since_load = 0;
+            frame_clock.start();
+        } else if (!aiming && !level->has_ball()) {
+            // A new round, as in Game::run_round
+            game_stat.sub_lives();
+            if (game_stat.has_lives()) {
+                level->reset_level();
+                game_stat.reset_lv_stats();
+                game_stat.reset_timer();
+                bar.reset();
+                aiming = true;
+                frame_clock.start();
+            }
+            continue;
+        }
+
+        // The key reaches the game a frame or so later, as it would from a terminal
+        feed_key(key_pipe[1], player.next_key(*level, aiming));
+
+        long long before = get_allocation_count();
+        int ticks;
+        {
+            ScopedPhase phase(&profiler, FrameProfiler::WAIT);
+            ticks = frame_clock.wait_for_frame();
+        }
+        if (aiming) {
+            // As in Level::launch_ball
+            reader.read_frame(ticks, keys);
+            for (int i = 0; i < ticks && aiming; i++) {
+                level->aim_ball(keys[i]);
+                aiming = keys[i] != ' ';
+            }
+            level->render_screen();
+        } else {
+            level->run_loop(ticks);
+        }
+        profiler.end_frame(ticks);
+        link_monitor.end_frame();
+        pf.set_reduced_detail(link_monitor.is_reduced());
+        long long allocations = get_allocation_count() - before;
+
+        if (frames_since_load++ < warm_up) {
+            continue;
+        }
+        ++result.frames_checked;
+        if (allocations > 0) {
+            if (result.first_allocating_frame < 0) {
+                result.first_allocating_frame = frames_since_load - 1;
+            }
+            ++result.allocating_frames;
+            result.allocations += allocations;
+        }
+    }
+
+    reader.stop();
+    close(key_pipe[0]);
+    close(key_pipe[1]);
+    pf.get_render_target().release();
+    if (level != NULL) {
+        level->destroy_objects();
+        delete level;
+    }
+    return status;
+}
+
+// Prints how to use the check.
+void print_usage() {
+    std::cerr << "Usage: alloc_check [-f frames] [-w warm_up_frames] [-o ncurses|ansi] [level.bl ...]" << std::endl;
+    std::cerr << "Without level files, checks every level in data/index.txt." << std::endl;
+    std::cerr << "Each level is drawn through both ncurses and the ANSI output, unless -o picks one." << std::endl;
+}
+
+// Checks every level given, or every level of the campaign.
+int main(int argc, char *argv[]) {
+    if (!is_counting_allocations()) {
+        std::cerr << "alloc_check must be linked with alloc_counter.o built with COUNT_ALLOCS." << std::endl;
+        return 1;
+    }
+
+    int frames = 5000, warm_up = 0;
+    std::vector<std::string> outputs = {"ncurses", "ansi"};
+    std::vector<std::string> level_files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-f" && i + 1 < argc) {
+            frames = std::atoi(argv[++i]);
+        } else if (arg == "-w" && i + 1 < argc) {
+            warm_up = std::atoi(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc && (std::string(argv[i + 1]) == "ncurses" || std::string(argv[i + 1]) == "ansi")) {
+            outputs = {argv[++i]};
+        } else if (arg[0] == '-') {
+            print_usage();
+            return 1;
+        } else {
+            level_files.push_back(arg);
+        }
+    }
+    if (level_files.empty()) {
+        std::ifstream fin("data/index.txt");
+        std::string level_file;
+        while (fin >> level_file) {
+            level_files.push_back(level_file);
+        }
+    }
+
+    // Draw into a terminal that nobody sees, so that the frames are drawn as in the game
+    const char *term = getenv("TERM");
+    FILE *null_out = fopen("/dev/null", "w");
+    SCREEN *screen = newterm(term != NULL ? term : "xterm", null_out, stdin);
+    if (screen == NULL) {
+        screen = newterm("vt100", null_out, stdin);
+    }
+    if (screen == NULL) {
+        std::cerr << "Failed to set up an off-screen terminal." << std::endl;
+        return 1;
+    }
+    resize_term(50, 200);
+    start_color();
+
+    std::vector<std::string> lines;
+    bool passed = true;
+    for (std::string output : outputs) {
+        for (std::string level_file : level_files) {
+            std::string name = level_file + " (" + output + ")";
+            AllocCheckResult result;
+            if (check_level(level_file, frames, warm_up, output == "ansi", null_out, result) != 0) {
+                lines.push_back(name + ": failed to load");
+                passed = false;
+                continue;
+            }
+            std::string line = name + ": " + std::to_string(result.frames_checked) + " frames checked, " +
+                               std::to_string(result.allocating_frames) + " allocated";
+            if (result.allocating_frames > 0) {
+                line += " (" + std::to_string(result.allocations) + " allocations, the first in frame " +
+                        std::to_string(result.first_allocating_frame) + ")";
+                passed = false;
+            }
+            lines.push_back(line);
+        }
+    }
+
+    endwin();
+    delscreen(screen);
+    fclose(null_out);
+
+    for (std::string line : lines) {
+        std::cout << line << std::endl;
+    }
+    std::cout << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef COUNT_ALLOCS
+
+namespace {
+
+std::atomic<long long> allocation_count{0};
+
+// Allocates memory with malloc and counts the allocation. Returns NULL if there is no memory left.
+// size: The number of bytes to allocate.
+void *counted_malloc(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+    void *ptr = counted_malloc(size);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size) {
+    void *ptr = counted_malloc(size);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return counted_malloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return counted_malloc(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+// Returns if allocations are being counted, i.e. this is a COUNT_ALLOCS build.
+bool is_counting_allocations() {
+    return true;
+}
+
+// Returns the number of calls to operator new so far.
+long long get_allocation_count() {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+#else
+
+// Returns if allocations are being counted, i.e. this is a COUNT_ALLOCS build.
+bool is_counting_allocations() {
+    return false;
+}
+
+// Returns the number of calls to operator new so far, which is always 0 when allocations are not counted.
+long long get_allocation_count() {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef ALLOC_COUNTER_H_
+#define ALLOC_COUNTER_H_
+
+// Counts the calls to operator new, to check that frames do not allocate memory once the game has warmed up.
+// Counting is a build mode: operator new is only replaced when alloc_counter.cpp is compiled with COUNT_ALLOCS
+// (see "alloc_check" in the makefile). Otherwise the count stays at 0.
+
+bool is_counting_allocations();
+long long get_allocation_count();
+
+#endif
@@ -0,0 +1,379 @@
+#include "ansi_target.h"
+#include "frame_buffer.h"
+#include "ncu.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Returns if the terminal has a string capability in its terminfo entry.
+// name: The terminfo name of the capability, e.g. "ech".
+static bool has_string_capability(const char *name) {
+    char *value = tigetstr((char *)name);
+    return value != NULL && value != (char *)-1;
+}
+
+// Constructs a target that draws the cells of a window. ncurses (and its color pairs) must have been initialized.
+// The window's part of the screen is taken over from ncurses on the first present().
+// window: The window to draw the cells of. Nothing is drawn to the window itself.
+// out: Where the terminal's output goes, e.g. stdout.
+AnsiTarget::AnsiTarget(WINDOW *window, FILE *out)
+    : window(window), out(out), top(getbegy(window)), left(getbegx(window)),
+      frame(getmaxy(window), getmaxx(window)), sent(getmaxy(window), getmaxx(window)) {
+    buffer.reserve(frame.get_rows() * frame.get_cols() * 4);
+
+    // Colors are sent as ncurses would send them, so pair 0 is only the terminal's default colors
+    // if ncurses was told to use them
+    int pair_count = std::max(1, std::min(COLOR_PAIRS, 256));
+    pair_fg.assign(pair_count, -1);
+    pair_bg.assign(pair_count, -1);
+    for (int pair = 0; pair < pair_count; pair++) {
+        short fg, bg;
+        if (pair_content(pair, &fg, &bg) == OK) {
+            pair_fg[pair] = fg;
+            pair_bg[pair] = bg;
+        }
+    }
+
+    can_erase = has_string_capability("ech");
+    erases_with_color = tigetflag((char *)"bce") > 0;
+    can_repeat = has_string_capability("rep");
+}
+
+// Sets the color pair of everything drawn after this.
+// color_pair: The color pair, or 0 for the default colors.
+void AnsiTarget::set_color(int color_pair) {
+    frame.set_color(color_pair);
+}
+
+// Draws a character in a cell.
+// r, c: The row and column of the cell.
+// ch: The character.
+void AnsiTarget::put_char(int r, int c, char ch) {
+    frame.put_char(r, c, ch);
+}
+
+// Draws a string from a cell to the right.
+// r, c: The row and column of the first character.
+// str: The string.
+void AnsiTarget::put_string(int r, int c, const char *str) {
+    frame.put_string(r, c, str);
+}
+
+// Draws a character in a number of cells from a cell to the right.
+// r, c: The row and column of the first cell.
+// ch: The character.
+// count: The number of cells.
+void AnsiTarget::fill_row(int r, int c, char ch, int count) {
+    frame.fill_row(r, c, ch, count);
+}
+
+// Draws a character in a number of cells from a cell downwards.
+// r, c: The row and column of the first cell.
+// ch: The character.
+// count: The number of cells.
+void AnsiTarget::fill_column(int r, int c, char ch, int count) {
+    frame.fill_column(r, c, ch, count);
+}
+
+// Draws a row of cells, each with its own character and color pair, into the frame being drawn.
+// r, c: The row and column of the first cell.
+// chars: The characters.
+// colors: The color pairs.
+// count: The number of cells.
+void AnsiTarget::put_cells(int r, int c, const char *chars, const int *colors, int count) {
+    frame.put_cells(r, c, chars, colors, count);
+}
+
+// Clears every cell of the frame being drawn. The terminal is only changed by present().
+void AnsiTarget::clear() {
+    frame.clear();
+}
+
+// Sends the cells that changed since the last frame to the terminal, after ncurses has sent every window
+// staged with wnoutrefresh() during the frame (the game stats and the notification bar).
+void AnsiTarget::present() {
+    doupdate();
+    if (!taken) {
+        take_screen();
+    }
+
+    buffer.assign("\033" "7");
+    cursor_r = cursor_c = cursor_color = -1;
+    for (int r = 0; r < frame.get_rows(); r++) {
+        send_row(r);
+    }
+
+    frame_bytes = 0;
+    if (buffer.size() > 2) {
+        buffer += "\033" "8";
+        fwrite(buffer.data(), 1, buffer.size(), out);
+        fflush(out);
+        frame_bytes = (int)buffer.size();
+    }
+    total_bytes += frame_bytes;
+    ++frame_count;
+}
+
+// Hands the window's part of the screen back to ncurses, before something else is drawn over it.
+// The last frame sent is copied into the window, so that ncurses knows what is on the screen again.
+void AnsiTarget::release() {
+    if (!taken) {
+        return;
+    }
+    for (int r = 0; r < sent.get_rows(); r++) {
+        for (int c = 0; c < sent.get_cols(); c++) {
+            wattrset(window, COLOR_PAIR(sent.get_color(r, c)));
+            mvwaddch(window, r, c, (unsigned char)sent.get_char(r, c));
+        }
+    }
+    wattrset(window, 0);
+    wrefresh(window);
+    taken = false;
+}
+
+// Takes the window's part of the screen over from ncurses.
+// ncurses keeps a copy of what it last sent to the screen (curscr), so the target starts from that.
+void AnsiTarget::take_screen() {
+    // Reading curscr moves its cursor, which is where ncurses thinks the terminal's cursor is
+    int cursor_y, cursor_x;
+    getyx(curscr, cursor_y, cursor_x);
+    for (int r = 0; r < sent.get_rows(); r++) {
+        for (int c = 0; c < sent.get_cols(); c++) {
+            chtype cell = mvwinch(curscr, top + r, left + c);
+            chtype ch = cell & A_CHARTEXT;
+            // A cell with other attributes than a color, or a character that is not ASCII, is always sent again
+            if ((cell & A_ATTRIBUTES & ~A_COLOR) == 0 && ch < 128) {
+                sent.set_color(PAIR_NUMBER(cell));
+                sent.put_char(r, c, (char)ch);
+            } else {
+                sent.set_color(-1);
+                sent.put_char(r, c, '\0');
+            }
+        }
+    }
+    wmove(curscr, cursor_y, cursor_x);
+    taken = true;
+}
+
+// Returns the number of bytes sent to the terminal for the last frame.
+int AnsiTarget::get_frame_bytes() {
+    return frame_bytes;
+}
+
+// Returns the number of bytes sent to the terminal for all the frames so far.
+long long AnsiTarget::get_total_bytes() {
+    return total_bytes;
+}
+
+// Returns the number of frames presented so far.
+int AnsiTarget::get_frame_count() {
+    return frame_count;
+}
+
+// Returns if a cell of the frame differs from what the terminal shows.
+// r, c: The row and column of the cell.
+bool AnsiTarget::changed(int r, int c) {
+    return frame.get_char(r, c) != sent.get_char(r, c) || frame.get_color(r, c) != sent.get_color(r, c);
+}
+
+// Adds the output for the cells of a row that changed to the buffer.
+// Each run of changed cells with the same character and color is sent together.
+// r: The row.
+void AnsiTarget::send_row(int r) {
+    int cols = frame.get_cols();
+    for (int c = frame.find_change(sent, r, 0); c < cols; c = frame.find_change(sent, r, c)) {
+        char ch = frame.get_char(r, c);
+        int color = frame.get_color(r, c);
+        int run = 1;
+        while (c + run < cols && changed(r, c + run) && frame.get_char(r, c + run) == ch &&
+               frame.get_color(r, c + run) == color) {
+            run++;
+        }
+
+        // Sending a few unchanged cells in the current color is cheaper than moving the cursor over them
+        int gap = c - cursor_c;
+        if (cursor_r == r && gap > 0 && gap <= move_cost(gap)) {
+            bool same_color = true;
+            for (int g = cursor_c; g < c; g++) {
+                same_color = same_color && frame.get_color(r, g) == cursor_color;
+            }
+            if (same_color) {
+                for (int g = cursor_c; g < c; g++) {
+                    buffer += frame.get_char(r, g);
+                }
+                cursor_c = c;
+            }
+        }
+
+        move_cursor(r, c);
+        change_color(color);
+        bool default_bg = color >= (int)pair_bg.size() || pair_bg[color] == -1;
+        if (ch == ' ' && can_erase && (erases_with_color || default_bg) && run > 6 + digit_count(run)) {
+            // ECH leaves the cursor where it is
+            buffer += "\033[";
+            append_number(run);
+            buffer += 'X';
+        } else if (can_repeat && run - 1 > 3 + digit_count(run - 1)) {
+            buffer += ch;
+            buffer += "\033[";
+            append_number(run - 1);
+            buffer += 'b';
+            cursor_c = c + run;
+        } else {
+            buffer.append(run, ch);
+            cursor_c = c + run;
+        }
+
+        sent.set_color(color);
+        sent.fill_row(r, c, ch, run);
+        c += run;
+    }
+}
+
+// Adds the shortest sequence that moves the cursor to a cell to the buffer.
+// r, c: The row and column of the cell in the window.
+void AnsiTarget::move_cursor(int r, int c) {
+    if (cursor_r == r && cursor_c == c) {
+        return;
+    }
+    // Escape sequences count rows and columns on the screen from 1
+    int screen_r = top + r + 1;
+    int screen_c = left + c + 1;
+
+    // Moving to an absolute position (CUP) always works. From a known position, the cursor can also be moved
+    // up or down and then left or right, or back to the first column with a carriage return and then up or down.
+    enum { ABSOLUTE, RELATIVE, RETURN } kind = ABSOLUTE;
+    int best = screen_c == 1 ? 3 + digit_count(screen_r) : 4 + digit_count(screen_r) + digit_count(screen_c);
+    if (cursor_r != -1) {
+        int rows = std::abs(r - cursor_r), cols = std::abs(c - cursor_c);
+        int relative = (rows > 0 ? move_cost(rows) : 0) + (cols > 0 ? move_cost(cols) : 0);
+        int carriage_return = 1 + (rows > 0 ? move_cost(rows) : 0);
+        if (relative < best) {
+            best = relative;
+            kind = RELATIVE;
+        }
+        if (screen_c == 1 && carriage_return < best) {
+            kind = RETURN;
+        }
+    }
+
+    if (kind == ABSOLUTE) {
+        buffer += "\033[";
+        append_number(screen_r);
+        if (screen_c != 1) {
+            buffer += ';';
+            append_number(screen_c);
+        }
+        buffer += 'H';
+    } else {
+        if (kind == RETURN) {
+            buffer += '\r';
+            cursor_c = c;
+        }
+        append_move(r - cursor_r, 'B', 'A');
+        append_move(c - cursor_c, 'C', 'D');
+    }
+
+    cursor_r = r;
+    cursor_c = c;
+}
+
+// Adds a relative cursor movement (e.g. ESC [ 5 C) to the buffer, if there is anything to move.
+// n: The number of cells to move by, positive or negative.
+// forward: The final byte of the sequence that moves by a positive number of cells.
+// backward: The final byte of the sequence that moves by a negative number of cells.
+void AnsiTarget::append_move(int n, char forward, char backward) {
+    if (n == 0) {
+        return;
+    }
+    buffer += "\033[";
+    if (std::abs(n) > 1) {
+        append_number(std::abs(n));
+    }
+    buffer += n > 0 ? forward : backward;
+}
+
+// Adds the SGR sequence that changes the colors to those of a color pair to the buffer.
+// Only the colors that differ from the current ones are changed.
+// color_pair: The color pair.
+void AnsiTarget::change_color(int color_pair) {
+    if (color_pair == cursor_color) {
+        return;
+    }
+    bool known = color_pair >= 0 && color_pair < (int)pair_fg.size();
+    int fg = known ? pair_fg[color_pair] : -1;
+    int bg = known ? pair_bg[color_pair] : -1;
+
+    if (fg == -1 && bg == -1) {
+        buffer += "\033[m";
+    } else if (cursor_color == -1) {
+        // Whatever ncurses left set is reset as well
+        buffer += "\033[0;";
+        append_color(30, fg);
+        buffer += ';';
+        append_color(40, bg);
+        buffer += 'm';
+    } else {
+        bool cursor_known = cursor_color < (int)pair_fg.size();
+        int old_fg = cursor_known ? pair_fg[cursor_color] : -1;
+        int old_bg = cursor_known ? pair_bg[cursor_color] : -1;
+        if (fg != old_fg || bg != old_bg) {
+            buffer += "\033[";
+            if (fg != old_fg) {
+                append_color(30, fg);
+            }
+            if (fg != old_fg && bg != old_bg) {
+                buffer += ';';
+            }
+            if (bg != old_bg) {
+                append_color(40, bg);
+            }
+            buffer += 'm';
+        }
+    }
+    cursor_color = color_pair;
+}
+
+// Adds a number in decimal to the buffer.
+// n: The number, which must not be negative.
+void AnsiTarget::append_number(int n) {
+    char digits[12];
+    int length = snprintf(digits, sizeof(digits), "%d", n);
+    buffer.append(digits, length);
+}
+
+// Adds the SGR parameter for a color to the buffer.
+// base: 30 for the foreground and 40 for the background.
+// color: The ncurses color number, or -1 for the default color.
+void AnsiTarget::append_color(int base, int color) {
+    if (color < 0) {
+        append_number(base + 9);
+    } else if (color < 8) {
+        append_number(base + color);
+    } else if (color < 16) {
+        append_number(base + 60 + color - 8);
+    } else {
+        append_number(base + 8);
+        buffer += ";5;";
+        append_number(color);
+    }
+}
+
+// Returns the number of bytes taken by a relative cursor movement (e.g. ESC [ 5 C) by a number of cells.
+// n: The number of cells, which must be positive.
+int AnsiTarget::move_cost(int n) {
+    return n == 1 ? 3 : 3 + digit_count(n);
+}
+
+// Returns the number of decimal digits of a number.
+// n: The number, which must not be negative.
+int AnsiTarget::digit_count(int n) {
+    int count = 1;
+    while (n >= 10) {
+        n /= 10;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,78 @@
+#include "frame_buffer.h"
+#include "ncu.h"
+#include "render_target.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef ANSI_TARGET_H_
+#define ANSI_TARGET_H_
+
+// Draws the cells of an ncurses window straight to the terminal with ANSI escape sequences, bypassing ncurses.
+//
+// Each frame is drawn into a FrameBuffer, and present() compares it with the last frame sent. Only the cells that
+// changed are sent, with the cheapest cursor movement and the fewest color changes, and runs of the same character
+// are sent as a single erase (ECH) or repeat (REP) when the terminal has them. The output is wrapped in
+// ESC 7 / ESC 8 (save and restore the cursor), so that ncurses does not lose track of the cursor.
+//
+// ncurses must not draw over the window's part of the screen while the target has it, as it does not know what
+// the target sent there. release() hands that part back to ncurses before e.g. the pause menu is drawn over it,
+// and the next present() takes it over again.
+class AnsiTarget : public RenderTarget {
+    public:
+        AnsiTarget(WINDOW *window, FILE *out);
+
+        void set_color(int color_pair);
+        void put_char(int r, int c, char ch);
+        void put_string(int r, int c, const char *str);
+        void fill_row(int r, int c, char ch, int count);
+        void fill_column(int r, int c, char ch, int count);
+        void put_cells(int r, int c, const char *chars, const int *colors, int count);
+        void clear();
+        void present();
+        void release();
+
+        int get_frame_bytes();
+        long long get_total_bytes();
+        int get_frame_count();
+
+    private:
+        WINDOW *window;
+        FILE *out;
+        // The position of the window's top-left cell on the screen, starting from 0.
+        int top, left;
+
+        // The frame being drawn, and the frame that the terminal shows.
+        FrameBuffer frame, sent;
+        // Whether the target has the window's part of the screen, rather than ncurses.
+        bool taken = false;
+        // The output of a frame is built here, and written with a single call.
+        std::string buffer;
+
+        // The SGR colors of each color pair (see append_color()).
+        std::vector<int> pair_fg, pair_bg;
+        // Whether the terminal can erase characters (ECH) and repeat the last character (REP),
+        // and whether erasing fills with the current background color (bce) instead of the default one.
+        bool can_erase, can_repeat, erases_with_color;
+
+        // Where the cursor is in the window and the color pair it draws with, or -1 if not known.
+        int cursor_r = -1, cursor_c = -1, cursor_color = -1;
+
+        int frame_bytes = 0;
+        long long total_bytes = 0;
+        int frame_count = 0;
+
+        void take_screen();
+        bool changed(int r, int c);
+        void send_row(int r);
+        void move_cursor(int r, int c);
+        void change_color(int color_pair);
+        void append_move(int n, char forward, char backward);
+        void append_number(int n);
+        void append_color(int base, int color);
+        static int move_cost(int n);
+        static int digit_count(int n);
+};
+
+#endif
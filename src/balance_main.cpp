@@ -0,0 +1,202 @@
+#include "math_utils.h"
+#include "power_up.h"
+#include "power_up_list.h"
+#include "sim_input.h"
+#include "simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The outcome of one game played by the balance tool.
+struct GameResult {
+    bool cleared = false;
+    int frames = 0;
+    int score = 0;
+    int lives = 0;
+    // How many of each power-up dropped and were caught, in the order of the power-up list.
+    std::vector<int> drawn, collected;
+};
+
+// Prints how to use the balance tool.
+void print_usage() {
+    std::cerr << "Usage: balance <level.bl> [-n games_per_thread] [-j threads] [-f max_frames] [--seed n]" << std::endl;
+    std::cerr << "Plays the level many times with the paddle following the lowest ball, on every core," << std::endl;
+    std::cerr << "and prints how often it is cleared, how long it takes, the scores and the power-ups dropped." << std::endl;
+}
+
+// Returns every power-up in the game.
+std::vector<PowerUp> all_power_ups() {
+    return {PowerUpList::PAD_EXPAND, PowerUpList::PAD_REDUCE, PowerUpList::FAST_BALL, PowerUpList::SLOW_BALL,
+            PowerUpList::MULTIBALL, PowerUpList::MULTIPLIER, PowerUpList::SHIELD, PowerUpList::MISSILE};
+}
+
+// Plays one game of a level and returns its outcome.
+// Game i is always played with the same seed, so the results do not depend on how games are split across threads.
+// level_file: The address of the level file to play.
+// seed: The seed of the whole balance run.
+// i: The number of the game.
+// max_frames: The most frames a game may last.
+// power_ups: The power-ups to count.
+GameResult play_game(std::string level_file, unsigned int seed, int i, int max_frames, std::vector<PowerUp> &power_ups) {
+    Simulation sim;
+    TrackingInput input;
+    sim.set_input(input);
+    sim.set_seed(derive_seed(seed, i));
+    sim.load_level(level_file);
+    sim.run(max_frames);
+
+    GameResult result;
+    result.cleared = sim.level_cleared();
+    result.frames = sim.get_frames();
+    result.score = sim.get_stat().get_score();
+    result.lives = sim.get_stat().get_lives();
+    for (PowerUp power_up : power_ups) {
+        result.drawn.push_back(sim.get_level().get_power_ups_drawn(power_up.id));
+        result.collected.push_back(sim.get_level().get_power_ups_collected(power_up.id));
+    }
+    return result;
+}
+
+// Plays every game whose number is first, first + step, first + 2 * step, ... and stores the outcomes.
+// Each thread writes to its own games in results, so no locking is needed.
+void play_games(std::string level_file, unsigned int seed, int first, int step, int max_frames,
+                std::vector<PowerUp> power_ups, std::vector<GameResult> &results) {
+    for (int i = first; i < (int)results.size(); i += step) {
+        results[i] = play_game(level_file, seed, i, max_frames, power_ups);
+    }
+}
+
+// Returns the value below which a given fraction of the sorted values lie.
+// values: The values, sorted in ascending order. Must not be empty.
+// fraction: Between 0 and 1, e.g. 0.9 for the 90th percentile.
+int percentile(std::vector<int> &values, double fraction) {
+    int index = (int)(fraction * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+// Prints the mean and spread of a list of values on one line.
+// name: The name of the values.
+// values: The values. They are sorted by this function.
+void print_distribution(std::string name, std::vector<int> &values) {
+    std::cout << name;
+    if (values.empty()) {
+        std::cout << " none" << std::endl;
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (int value : values) {
+        sum += value;
+    }
+    std::cout << " mean " << sum / values.size()
+              << " min " << values.front()
+              << " p10 " << percentile(values, 0.1)
+              << " p50 " << percentile(values, 0.5)
+              << " p90 " << percentile(values, 0.9)
+              << " max " << values.back() << std::endl;
+}
+
+// Plays a level many times across all cores and prints a summary of how the games went.
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+
+    std::string level_file = argv[1];
+    int games_per_thread = 1000, max_frames = 100000;
+    int threads = std::max(1, (int)std::thread::hardware_concurrency());
+    unsigned int seed = 1;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            print_usage();
+            return 1;
+        }
+        if (arg == "-n") {
+            games_per_thread = std::atoi(argv[++i]);
+        } else if (arg == "-j") {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "-f") {
+            max_frames = std::atoi(argv[++i]);
+        } else if (arg == "--seed") {
+            seed = (unsigned int)std::strtoul(argv[++i], NULL, 10);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    // Every count must be positive, including ones that are not numbers at all (read as 0)
+    if (games_per_thread <= 0 || threads <= 0 || max_frames <= 0) {
+        print_usage();
+        return 1;
+    }
+
+    // Check the level once, so that the threads do not all fail on their own
+    {
+        Simulation sim;
+        if (sim.load_level(level_file) != 0) {
+            std::cerr << "Failed to load " << level_file << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<PowerUp> power_ups = all_power_ups();
+    std::vector<GameResult> results(games_per_thread * threads);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread(play_games, level_file, seed, t, threads, max_frames, power_ups, std::ref(results)));
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Summarize
+    int cleared = 0;
+    std::vector<int> frames_to_clear, scores, lives;
+    std::vector<long long> drawn(power_ups.size()), collected(power_ups.size());
+    long long total_drawn = 0, total_frames = 0;
+    for (GameResult &result : results) {
+        if (result.cleared) {
+            ++cleared;
+            frames_to_clear.push_back(result.frames);
+        }
+        scores.push_back(result.score);
+        lives.push_back(result.lives);
+        total_frames += result.frames;
+        for (size_t p = 0; p < power_ups.size(); p++) {
+            drawn[p] += result.drawn[p];
+            collected[p] += result.collected[p];
+            total_drawn += result.drawn[p];
+        }
+    }
+
+    int games = results.size();
+    std::cout << "level " << level_file << std::endl;
+    std::cout << "games " << games
+              << " threads " << threads
+              << " seconds " << seconds
+              << " games_per_second " << (seconds > 0 ? games / seconds : 0)
+              << " frames_per_second " << (seconds > 0 ? total_frames / seconds : 0) << std::endl;
+    std::cout << "clear_rate " << (games > 0 ? (double)cleared / games : 0) << std::endl;
+    print_distribution("frames_to_clear", frames_to_clear);
+    print_distribution("score", scores);
+    print_distribution("lives_left", lives);
+    for (size_t p = 0; p < power_ups.size(); p++) {
+        std::cout << "power_up " << power_ups[p].abbr
+                  << " drawn_per_game " << (games > 0 ? (double)drawn[p] / games : 0)
+                  << " share " << (total_drawn > 0 ? (double)drawn[p] / total_drawn : 0)
+                  << " collected_per_game " << (games > 0 ? (double)collected[p] / games : 0) << std::endl;
+    }
+    return 0;
+}
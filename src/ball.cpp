@@ -2,10 +2,10 @@
 #include "ncu.h"
 #include "paddle.h"
 #include "playing_field.h"
-#include "rect_block.h"
 #include "rect_wall.h"
 #include "well.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -15,7 +15,6 @@
 Ball::Ball(Vector2 pos, Vector2 base_vel) {
     Ball::pos = pos;
     Ball::base_vel = base_vel;
-    new_vel = base_vel;
 }
 
 // Sets the ball's speed multiplier, making it move faster or slower.
@@ -29,13 +28,29 @@ Vector2 Ball::vel() {
     return base_vel.scale(speed_multi);
 }
 
+// Returns the position of the ball.
+Vector2 Ball::get_pos() {
+    return pos;
+}
+
+// Returns the range of cells on the screen that the ball is drawn on (starting and ending rows and columns).
+// pfield: The playing field to draw on.
+// &r1: The starting row.
+// &r2: The ending row.
+// &c1: The starting column.
+// &c2: The ending column.
+// All 4 pass-by-reference variables are outputs of the function.
+void Ball::get_drawing_range(PlayingField &pfield, int &r1, int &r2, int &c1, int &c2) {
+    r1 = r2 = pfield.row_y(pos.y);
+    c1 = c2 = pfield.col_x(pos.x);
+}
+
 // Draw the ball on a PlayingField.
 // pfield: The PlayingField that the ball is drawn on.
-void Ball::draw_pf(PlayingField pfield) {
+void Ball::draw_pf(PlayingField &pfield) {
     int r = pfield.row_y(pos.y);
     int c = pfield.col_x(pos.x);
-    wmove(pfield.get_display_window(), r, c);
-    wprintw(pfield.get_display_window(), "o");
+    pfield.get_render_target().put_char(r, c, 'o');
     return;
 }
 
@@ -44,96 +59,124 @@ double Ball::speed() {
     return vel().magnitude();
 }
 
-// Applies the new ball's velocity (due to wall collisions)
-// to its actual velocity used in calculations.
-void Ball::update_velocity() {
-    base_vel = new_vel;
-}
-
-// Returns the position of the ball on the next frame.
-Vector2 Ball::get_next_pos(double factor) {
-    return pos.add(vel().scale(factor));
+// Moves the ball in a straight line along its velocity.
+// factor: Scaling factor for the change in position, i.e. the fraction of a frame to move for.
+void Ball::move_by_velocity(double factor) {
+    pos = pos.add(vel().scale(factor));
 }
 
-// Simulates the ball's movement in a frame.
-// factor: Scaling factor for the change in position.
-void Ball::move_by_velocity(double factor) {
-    update_velocity();
-    pos = get_next_pos(factor);
+// Records a hit if it happens before the earliest hit found so far.
+// hit: The earliest hit found so far. Modified by this function.
+// type: What the ball hits.
+// time: When the ball hits it, as a fraction of the movement.
+// flip_x, flip_y: Which parts of the velocity the bounce reverses.
+// brick: The id of the brick hit, if any.
+void Ball::offer_hit(BallHit &hit, BallHit::Type type, double time, bool flip_x, bool flip_y, int brick) {
+    if (time < hit.time || (hit.type == BallHit::NONE && time <= hit.time)) {
+        hit.type = type;
+        hit.time = time;
+        hit.flip_x = flip_x;
+        hit.flip_y = flip_y;
+        hit.brick = brick;
+    }
 }
 
-// Checks if the ball hits the well, and make it bounce if it does.
-// If the shield is on, also checks if the ball collides with the shield.
-// If it does, bounce the ball up and consume the shield.
+// Checks if the ball reaches a side of the well while moving, and records it in hit if it is the earliest.
+// The bottom of the well only counts if the shield is on.
 // well: The well to check collision against.
-// factor: Scaling factor for the change in position.
-void Ball::if_collide_rebound(Well &well, double factor) {
+// factor: The fraction of a frame that the ball moves for.
+// hit: The earliest hit found so far. Modified by this function.
+void Ball::find_hit(Well &well, double factor, BallHit &hit) {
     Rect inner_box = well.get_inner_box();
-    Vector2 new_pos = get_next_pos(factor);
+    Vector2 move = vel().scale(factor);
 
-    if (new_pos.x < inner_box.pos1.x) {
-        new_vel.x = std::abs(base_vel.x);
-    } else if (new_pos.x > inner_box.pos2.x) {
-        new_vel.x = -std::abs(base_vel.x);
+    if (move.x < 0) {
+        offer_hit(hit, BallHit::WELL, std::max(0.0, (inner_box.pos1.x - pos.x) / move.x), true, false);
+    } else if (move.x > 0) {
+        offer_hit(hit, BallHit::WELL, std::max(0.0, (inner_box.pos2.x - pos.x) / move.x), true, false);
     }
 
-    if (new_pos.y > inner_box.pos2.y) {
-        new_vel.y = -std::abs(base_vel.y);
-    }
-
-    // When the ball tries to escape the wall via the bottom
-    if (new_pos.y < inner_box.pos1.y && base_vel.y < 0) {
-        if (well.shield.is_intact()) {
-            well.shield.destroy();
-            new_vel.y = std::abs(base_vel.y);
-        }
+    if (move.y > 0) {
+        offer_hit(hit, BallHit::WELL, std::max(0.0, (inner_box.pos2.y - pos.y) / move.y), false, true);
+    } else if (move.y < 0 && well.shield.is_intact()) {
+        // When the ball tries to escape the wall via the bottom
+        offer_hit(hit, BallHit::SHIELD, std::max(0.0, (inner_box.pos1.y - pos.y) / move.y), false, true);
     }
 }
 
-// Checks if the ball hits the paddle. If it does, reflect the ball based on where it is hit.
+// Checks if the ball reaches the paddle while moving down, and records it in hit if it is the earliest.
+// A ball that is already inside the paddle's hitbox hits it straight away.
 // paddle: The paddle to check collision against.
-// factor: Scaling factor for the change in position.
-void Ball::if_collide_rebound(Paddle paddle, double factor) {
-    if (vel().y > 0) {
+// factor: The fraction of a frame that the ball moves for.
+// hit: The earliest hit found so far. Modified by this function.
+void Ball::find_hit(const Paddle &paddle, double factor, BallHit &hit) {
+    Vector2 move = vel().scale(factor);
+    if (move.y >= 0) {
         return;
     }
-    if (paddle.can_hit_ball(get_next_pos(factor))) {
+
+    Rect hitbox = paddle.get_ball_hitbox();
+    double time;
+    bool hit_x, hit_y;
+    if (hitbox.contains_point(pos)) {
+        offer_hit(hit, BallHit::PADDLE, 0, false, false);
+    } else if (hitbox.sweep(pos, move, time, hit_x, hit_y)) {
+        offer_hit(hit, BallHit::PADDLE, time, false, false);
+    }
+}
+
+// Checks if the ball runs into a brick while moving, and records it in hit if it is the earliest.
+// If the ball hits the corner of the brick, it will be reflected diagonally.
+// brick_rect: The rect that the brick occupies.
+// brick: The id of the brick.
+// factor: The fraction of a frame that the ball moves for.
+// hit: The earliest hit found so far. Modified by this function.
+void Ball::find_hit(Rect brick_rect, int brick, double factor, BallHit &hit) {
+    double time;
+    bool hit_x, hit_y;
+    if (brick_rect.sweep(pos, vel().scale(factor), time, hit_x, hit_y)) {
+        offer_hit(hit, BallHit::BRICK, time, hit_x, hit_y, brick);
+    }
+}
+
+// Makes the ball bounce off whatever it has hit. The ball should already be at the point of impact.
+// Hitting the shield consumes it. Breaking the brick hit, if any, is left to the caller.
+// A ball that hits the paddle is reflected based on where it hits the paddle.
+// hit: What the ball has hit.
+// well: The well of the playing field.
+// paddle: The paddle of the playing field.
+void Ball::rebound(BallHit &hit, Well &well, const Paddle &paddle) {
+    if (hit.type == BallHit::PADDLE) {
         double deflection_angle = paddle.get_deflection_angle(pos.x);
 
         double mag_vel = base_vel.magnitude();
-        new_vel.x = std::sin(deflection_angle) * mag_vel;
-        new_vel.y = std::cos(deflection_angle) * mag_vel;
+        base_vel.x = std::sin(deflection_angle) * mag_vel;
+        base_vel.y = std::cos(deflection_angle) * mag_vel;
+        return;
     }
-}
 
-// Checks if the ball hits the brick, and make it bounce if it does.
-// If the ball (somehow) hits the corner of the brick, it will be reflected diagonally.
-// brick: The brick to check collision against.
-// factor: Scaling factor for the change in position.
-void Ball::if_collide_rebound(RectBlock *brick, double factor) {
-    Vector2 next_pos = get_next_pos(factor);
-    if (brick->get_rect().contains_point({next_pos.x, pos.y})) {
-        new_vel = base_vel.horizontal_flip();
-        brick->break_brick();
-    } else if (brick->get_rect().contains_point({pos.x, next_pos.y})) {
-        new_vel = base_vel.vertical_flip();
-        brick->break_brick();
-    } else if (brick->get_rect().contains_point(next_pos)) {
-        new_vel = base_vel.flip();
-        brick->break_brick();
+    if (hit.type == BallHit::SHIELD) {
+        well.shield.destroy();
+    }
+
+    if (hit.flip_x) {
+        base_vel = base_vel.horizontal_flip();
+    }
+    if (hit.flip_y) {
+        base_vel = base_vel.vertical_flip();
     }
 }
 
 // Returns if the ball is below the screen (defined as the bottom of the well).
 // well: The well to use for checking if the ball is below the well.
-bool Ball::outside_well(Well well) {
+bool Ball::outside_well(Well &well) {
     return well.is_below_well(pos.y);
 }
 
 // Moves the ball to the top-centre of the paddle.
 // paddle: The paddle used to calculate the ball's new position.
 // offset: Where the ball should be placed. -1 is the left and 1 is the right.
-void Ball::move_to_paddle(Paddle paddle, double offset) {
+void Ball::move_to_paddle(const Paddle &paddle, double offset) {
     double len = paddle.length();
     pos = paddle.get_pos().add({len * offset * 0.5, 1});
 }
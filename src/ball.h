@@ -1,51 +1,58 @@
 #include "paddle.h"
 #include "playing_field.h"
-#include "rect_block.h"
 #include "rect_wall.h"
 #include "well.h"
 
 #ifndef BALL_H_
 #define BALL_H_
 
+// The first thing that a ball runs into while moving.
+struct BallHit {
+        enum Type { NONE, WELL, SHIELD, PADDLE, BRICK };
+
+        Type type = NONE;
+        // The fraction of the movement completed when the ball hits something (0 to 1).
+        double time = 1;
+        // Which parts of the velocity are reversed by the bounce.
+        bool flip_x = false, flip_y = false;
+        // The id of the brick hit, if any.
+        int brick = -1;
+};
+
 // A round spherical object that is responsible for player's control.
 // It moves in a 2D plane which allows breaking blocks to achieve the main objective of the game.
 class Ball {
     public:
-        // The maximum distance a ball can move before checking for collision.
-        // Beyond this value, the ball may clip through walls.
-
-        const double max_stepping = 0.1;
-
         Ball(Vector2 pos, Vector2 base_vel);
-        void draw_pf(PlayingField pfield);
+        void get_drawing_range(PlayingField &pfield, int &r1, int &r2, int &c1, int &c2);
+        void draw_pf(PlayingField &pfield);
         double speed();
 
-        Vector2 get_next_pos(double factor);
         void move_by_velocity(double factor);
 
-        void if_collide_rebound(Well &well, double factor);
-        void if_collide_rebound(Paddle paddle, double factor);
-        void if_collide_rebound(RectBlock *rectwall, double factor);
+        void find_hit(Well &well, double factor, BallHit &hit);
+        void find_hit(const Paddle &paddle, double factor, BallHit &hit);
+        void find_hit(Rect brick_rect, int brick, double factor, BallHit &hit);
+        void rebound(BallHit &hit, Well &well, const Paddle &paddle);
 
         Vector2 vel();
+        Vector2 get_pos();
 
         void set_speed_multi(double val);
 
-        void move_to_paddle(Paddle paddle, double offset = 0);
+        void move_to_paddle(const Paddle &paddle, double offset = 0);
 
-        bool outside_well(Well well);
+        bool outside_well(Well &well);
 
         // Positive = Faster, Negative = Slower
         double frame = 0;
 
     private:
         Vector2 pos, base_vel;
-        // The purpose of new_vel_x and new_vel_y is to prevent rebouncing twice upon detection
-        Vector2 new_vel = base_vel;
 
         double speed_multi = 1.0;
 
-        void update_velocity();
+        void offer_hit(BallHit &hit, BallHit::Type type, double time, bool flip_x, bool flip_y, int brick = -1);
 };
 
-#endif
\ No newline at end of file
+#endif
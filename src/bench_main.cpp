@@ -0,0 +1,741 @@
+#include "ansi_target.h"
+#include "ball.h"
+#include "frame_buffer.h"
+#include "game_stat.h"
+#include "level.h"
+#include "level_pack.h"
+#include "loot_table.h"
+#include "ncu.h"
+#include "notification_bar.h"
+#include "playing_field.h"
+#include "sim_input.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// The outcome of one benchmark: how many operations were timed and how long they took in total.
+// Benchmarks that draw to the terminal also count the bytes sent to it; the others leave bytes at 0.
+struct BenchResult {
+    std::string name;
+    long long ops;
+    double seconds;
+    long long bytes;
+};
+
+// Adds up the time spent in the timed parts of a benchmark, leaving out its setup.
+class Stopwatch {
+    public:
+        // Starts timing.
+        void start() {
+            started = std::chrono::steady_clock::now();
+        }
+
+        // Stops timing and adds the time since start() to the total.
+        void stop() {
+            total += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        }
+
+        // Returns the total time timed, in seconds.
+        double seconds() {
+            return total;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point started;
+        double total = 0;
+};
+
+// Benchmarks of the steps of a frame. Level lets this class call its private members.
+// Every benchmark uses fixed seeds, so each run does the same work.
+class LevelBenchmarks {
+    public:
+        // Where bench_render_screen() draws to.
+        enum Backend { WINDOW_TARGET, FRAME_BUFFER_TARGET, ANSI_TARGET };
+
+        LevelBenchmarks(double min_seconds, std::string filter, FILE *terminal_out);
+
+        void bench_move_ball(int ball_count, double speed_multi);
+        void bench_remove_broken_block();
+        void bench_handle_missile(int missile_count);
+        void bench_draw_power_up();
+        void bench_draw_power_ups();
+        void bench_load_level(std::string level_file, bool compiled);
+        void bench_render_screen(std::string level_file, bool full_redraw, Backend backend);
+        void bench_render_walls(bool walls, Backend backend);
+        void bench_simulate_frame(std::string level_file, bool profiled);
+        void bench_open_campaign(bool packed);
+        void bench_load_generated_level(int brick_count);
+
+        std::vector<BenchResult> &get_results();
+
+    private:
+        // Each benchmark keeps running until it has timed at least this long.
+        double min_seconds;
+        // Only benchmarks whose names contain this are run.
+        std::string filter;
+        std::vector<BenchResult> results;
+        // The file that the off-screen terminal writes to.
+        FILE *terminal_out;
+
+        PlayingField pf = PlayingField({32.0, 32.0});
+        NotificationBar bar = NotificationBar(64, 1);
+        GameStat game_stat;
+
+        bool selected(std::string name);
+        void bind(Level &level);
+        void fill_bricks(Level &level, bool unbreakable);
+};
+
+// Sets up the benchmarks.
+// min_seconds: How long to time each benchmark for, at least.
+// filter: Only benchmarks whose names contain this are run. An empty filter runs every benchmark.
+// terminal_out: The file that the off-screen terminal writes to. It must be seekable, so that its output can be counted.
+LevelBenchmarks::LevelBenchmarks(double min_seconds, std::string filter, FILE *terminal_out) {
+    LevelBenchmarks::min_seconds = min_seconds;
+    LevelBenchmarks::filter = filter;
+    LevelBenchmarks::terminal_out = terminal_out;
+    pf.set_display_window();
+    game_stat.set_display_window(pf.max_x, pf.max_y);
+    bar.set_display_window(pf.max_y + 6);
+}
+
+// Returns if a benchmark should be run.
+// name: The name of the benchmark.
+bool LevelBenchmarks::selected(std::string name) {
+    return name.find(filter) != std::string::npos;
+}
+
+// Connects a level to the playing field, stats and notification bar of the benchmarks.
+// level: The level to connect.
+void LevelBenchmarks::bind(Level &level) {
+    level.bind_stat(game_stat);
+    level.bind_playing_field(pf);
+    level.bind_notification_bar(bar);
+    level.set_seed(1);
+}
+
+// Replaces the bricks of a level with a dense grid of 14 x 20 bricks filling the top two thirds of the well.
+// level: The level to fill.
+// unbreakable: Whether the bricks can be broken.
+void LevelBenchmarks::fill_bricks(Level &level, bool unbreakable) {
+    level.bricks.clear();
+    level.brick_grid.clear();
+    for (int row = 0; row < 20; row++) {
+        for (int col = 0; col < 14; col++) {
+            double x = -14.0 + col * 2.0;
+            double y = 14.5 - row * 1.0;
+            level.add_brick({x, y - 0.5, x + 2.0, y}, 32, unbreakable);
+        }
+    }
+}
+
+// Times Level::move_ball on a number of balls bouncing around a level full of unbreakable bricks.
+// One operation is one ball moved for one frame.
+// ball_count: The number of balls.
+// speed_multi: The speed of the balls, as a multiple of the starting speed.
+void LevelBenchmarks::bench_move_ball(int ball_count, double speed_multi) {
+    std::string name = "move_ball/balls=" + std::to_string(ball_count) + "/speed=" + std::to_string((int)speed_multi);
+    if (!selected(name)) {
+        return;
+    }
+
+    Level level;
+    bind(level);
+    fill_bricks(level, true);
+
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<double> x_dist(-14.0, 14.0), y_dist(-9.0, -6.0), angle_dist(0.0, 6.283);
+    std::vector<Ball> balls, starts;
+    for (int i = 0; i < ball_count; i++) {
+        double angle = angle_dist(engine);
+        Ball ball({x_dist(engine), y_dist(engine)}, {0.6 * std::cos(angle), 0.6 * std::sin(angle)});
+        ball.set_speed_multi(speed_multi);
+        balls.push_back(ball);
+    }
+    starts = balls;
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        watch.start();
+        for (Ball &ball : balls) {
+            level.move_ball(ball);
+        }
+        watch.stop();
+        ops += ball_count;
+
+        // Balls that fall out of the well start again
+        for (int i = 0; i < ball_count; i++) {
+            if (balls[i].outside_well(level.well)) {
+                balls[i] = starts[i];
+            }
+        }
+    }
+    level.destroy_objects();
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times Level::remove_broken_block on a dense level, one brick broken at a time in a random order.
+// One operation is one call that removes one brick, including the power-ups it drops.
+void LevelBenchmarks::bench_remove_broken_block() {
+    std::string name = "remove_broken_block/dense";
+    if (!selected(name)) {
+        return;
+    }
+
+    Level level;
+    bind(level);
+    std::mt19937 engine(1);
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        fill_bricks(level, false);
+        while (!level.power_up_drops.empty()) {
+            level.delete_power_up_drop(level.power_up_drops.back());
+        }
+
+        std::vector<int> order;
+        for (int id = 0; id < level.bricks.slot_count(); id++) {
+            if (level.bricks.exists(id)) {
+                order.push_back(id);
+            }
+        }
+        std::shuffle(order.begin(), order.end(), engine);
+
+        watch.start();
+        for (int id : order) {
+            level.bricks.break_brick(id);
+            level.remove_broken_block();
+        }
+        watch.stop();
+        ops += order.size();
+    }
+    level.destroy_objects();
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times Level::handle_missile on a dense level with a number of missiles flying up through the bricks.
+// One operation is one frame: moving every missile, then removing the bricks they broke.
+// missile_count: The number of missiles kept on the field.
+void LevelBenchmarks::bench_handle_missile(int missile_count) {
+    std::string name = "handle_missile/dense/missiles=" + std::to_string(missile_count);
+    if (!selected(name)) {
+        return;
+    }
+
+    Level level;
+    bind(level);
+    fill_bricks(level, false);
+    int full_count = level.get_remaining_breakable_blocks();
+
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<double> x_dist(-14.5, 14.5), y_dist(-12.0, -6.0);
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        // Refill the missiles, and the bricks when half of them are gone
+        while ((int)level.missiles.size() < missile_count) {
+            level.add_missile({x_dist(engine), y_dist(engine)}, 0.8);
+        }
+        if (level.get_remaining_breakable_blocks() < full_count / 2) {
+            fill_bricks(level, false);
+        }
+        while (!level.power_up_drops.empty()) {
+            level.delete_power_up_drop(level.power_up_drops.back());
+        }
+
+        watch.start();
+        level.handle_missile();
+        level.remove_broken_block();
+        watch.stop();
+        ++ops;
+    }
+    level.destroy_objects();
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times LootTable::draw_power_up with the default weights. One operation is one draw.
+void LevelBenchmarks::bench_draw_power_up() {
+    std::string name = "draw_power_up";
+    if (!selected(name)) {
+        return;
+    }
+
+    LootTable table;
+    table.seed(1);
+
+    Stopwatch watch;
+    long long ops = 0;
+    int checksum = 0;
+    while (watch.seconds() < min_seconds) {
+        watch.start();
+        for (int i = 0; i < 100000; i++) {
+            checksum += table.draw_power_up().id;
+        }
+        watch.stop();
+        ops += 100000;
+    }
+    // Use the draws, so that they cannot be optimized away
+    if (checksum == 0) {
+        std::cerr << "draw_power_up: no power-ups drawn" << std::endl;
+    }
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times loading a level from a .bl file into a new level. One operation is one level loaded.
+// Creating and freeing the level is not timed, as it costs the same however the level is stored.
+// level_file: The address of the level file.
+// compiled: If true, the level is loaded from its compiled level (.blc) file instead, which must have been made with "make levels".
+void LevelBenchmarks::bench_load_level(std::string level_file, bool compiled) {
+    if (compiled) {
+        level_file += "c";
+    }
+    std::string name = std::string("load_level/") + (compiled ? "compiled/" : "text/") + level_file;
+    if (!selected(name)) {
+        return;
+    }
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        Level *level = new Level();
+        bind(*level);
+        watch.start();
+        int failed = compiled ? level->load_level_by_image(level_file) : level->load_level_by_text(level_file);
+        watch.stop();
+        level->destroy_objects();
+        delete level;
+        ++ops;
+
+        if (failed) {
+            std::cerr << "Failed to load " << level_file << std::endl;
+            return;
+        }
+    }
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times LootTable::draw_power_ups with the default weights, drawing 1000 power-ups per call. One operation is one draw.
+void LevelBenchmarks::bench_draw_power_ups() {
+    std::string name = "draw_power_ups/bulk";
+    if (!selected(name)) {
+        return;
+    }
+
+    LootTable table;
+    table.seed(1);
+    std::vector<int> ids;
+
+    Stopwatch watch;
+    long long ops = 0;
+    long long checksum = 0;
+    while (watch.seconds() < min_seconds) {
+        watch.start();
+        for (int i = 0; i < 100; i++) {
+            ids.clear();
+            table.draw_power_ups(1000, ids);
+            checksum += ids.back();
+        }
+        watch.stop();
+        ops += 100000;
+    }
+    // Use the draws, so that they cannot be optimized away
+    if (checksum == 0) {
+        std::cerr << name << ": no power-ups drawn" << std::endl;
+    }
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times loading a large generated level from the text of a .bl file in memory, so that only parsing and building are timed.
+// One operation is one level loaded.
+// brick_count: The number of "cst rbk" commands in the level.
+void LevelBenchmarks::bench_load_generated_level(int brick_count) {
+    std::string name = "load_level/generated/" + std::to_string(brick_count);
+    if (!selected(name)) {
+        return;
+    }
+
+    std::string text;
+    for (int i = 0; i < brick_count; i++) {
+        double x = -14.0 + (i % 100) * 0.28, y = (i / 100 % 100) * 0.14;
+        text += "cst rbk " + std::to_string(x) + " " + std::to_string(y) + " " +
+                std::to_string(x + 0.25) + " " + std::to_string(y + 0.12) + " " + std::to_string(8 + i % 6 * 8) + "\n";
+    }
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        Level *level = new Level();
+        bind(*level);
+        watch.start();
+        level->load_level_by_text(text.data(), text.size(), name);
+        watch.stop();
+        level->destroy_objects();
+        delete level;
+        ++ops;
+    }
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times opening the campaign and reading every level in it, as the game does over a whole game.
+// One operation is the campaign opened and every level read once.
+// packed: If true, reads data/levels.pack, which must have been made with "make levels".
+// Otherwise, reads data/index.txt and then each level file it lists.
+void LevelBenchmarks::bench_open_campaign(bool packed) {
+    std::string name = std::string("open_campaign/") + (packed ? "pack" : "files");
+    if (!selected(name)) {
+        return;
+    }
+
+    Stopwatch watch;
+    long long ops = 0;
+    size_t bytes = 0;
+    while (watch.seconds() < min_seconds) {
+        watch.start();
+        if (packed) {
+            LevelPack pack;
+            if (!pack.open("data/levels.pack")) {
+                std::cerr << "Failed to open data/levels.pack" << std::endl;
+                return;
+            }
+            for (std::string level_name : pack.get_level_names()) {
+                const char *data;
+                size_t size;
+                if (pack.read(level_name, data, size)) {
+                    bytes += size;
+                }
+            }
+        } else {
+            std::ifstream index("data/index.txt");
+            std::string level_file;
+            while (index >> level_file) {
+                std::ifstream fin(level_file);
+                std::string contents((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+                bytes += contents.size();
+            }
+        }
+        watch.stop();
+        ++ops;
+    }
+    if (bytes == 0) {
+        std::cerr << "No levels read for " << name << std::endl;
+        return;
+    }
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times Level::render_screen while a level is being played, drawing into an off-screen terminal through ncurses
+// or an AnsiTarget, or into a FrameBuffer to leave out the terminal altogether.
+// One operation is one frame drawn. The bytes sent to the terminal are counted as well, which include the game stats
+// (drawn through ncurses) with every backend.
+// level_file: The address of the level file to play.
+// full_redraw: Whether every frame draws the whole playing field, instead of only what changed.
+// backend: What to draw to.
+void LevelBenchmarks::bench_render_screen(std::string level_file, bool full_redraw, Backend backend) {
+    const char *backend_names[] = {"", "framebuffer/", "ansi/"};
+    std::string name = std::string("render_screen/") + backend_names[backend] +
+                       (full_redraw ? "full/" : "incremental/") + level_file;
+    if (!selected(name)) {
+        return;
+    }
+
+    FrameBuffer frame(pf.max_y, pf.max_x);
+    AnsiTarget ansi(pf.get_display_window(), terminal_out);
+    if (backend == FRAME_BUFFER_TARGET) {
+        pf.set_render_target(frame);
+    } else if (backend == ANSI_TARGET) {
+        pf.set_render_target(ansi);
+    }
+    long long bytes = 0;
+
+    Level *level = NULL;
+    TrackingInput input;
+    bool aiming = true;
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        // Play the level, starting it again whenever it ends
+        if (level == NULL || !level->has_ball() || level->all_bricks_destroyed()) {
+            if (level != NULL) {
+                level->destroy_objects();
+                delete level;
+            }
+            game_stat.reset_all_stats();
+            level = new Level();
+            bind(*level);
+            level->load_level_by_file(level_file);
+            aiming = true;
+        }
+        int ch = input.next_key(*level, aiming);
+        if (aiming) {
+            level->aim_ball(ch);
+            aiming = ch != ' ';
+        } else {
+            level->simulate_frame(ch);
+        }
+
+        level->full_redraw = level->full_redraw || full_redraw;
+        fflush(terminal_out);
+        off_t written = lseek(fileno(terminal_out), 0, SEEK_CUR);
+        watch.start();
+        level->render_screen();
+        // A frame buffer does not send anything, so the game stats staged during the frame are sent here
+        if (backend == FRAME_BUFFER_TARGET) {
+            doupdate();
+        }
+        watch.stop();
+        fflush(terminal_out);
+        bytes += lseek(fileno(terminal_out), 0, SEEK_CUR) - written;
+        ++ops;
+    }
+
+    level->destroy_objects();
+    delete level;
+    pf.reset_render_target();
+    results.push_back({name, ops, watch.seconds(), bytes});
+}
+
+// Times Level::render_screen while balls bounce around a level full of unbreakable bricks, or around the same well
+// with no bricks at all. The walls are drawn once into the level's static layer, so both should take about as long.
+// One operation is one frame drawn.
+// walls: Whether the level is full of unbreakable bricks.
+// backend: What to draw to.
+void LevelBenchmarks::bench_render_walls(bool walls, Backend backend) {
+    const char *backend_names[] = {"", "framebuffer/", "ansi/"};
+    std::string name = std::string("render_walls/") + backend_names[backend] + (walls ? "walls" : "empty");
+    if (!selected(name)) {
+        return;
+    }
+
+    FrameBuffer frame(pf.max_y, pf.max_x);
+    AnsiTarget ansi(pf.get_display_window(), terminal_out);
+    if (backend == FRAME_BUFFER_TARGET) {
+        pf.set_render_target(frame);
+    } else if (backend == ANSI_TARGET) {
+        pf.set_render_target(ansi);
+    }
+
+    Level level;
+    bind(level);
+    if (walls) {
+        fill_bricks(level, true);
+    } else {
+        level.bricks.clear();
+        level.brick_grid.clear();
+    }
+    level.init_brick_lists();
+
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<double> x_dist(-14.0, 14.0), y_dist(-9.0, -6.0), angle_dist(0.0, 6.283);
+    std::vector<Ball> starts;
+    for (int i = 0; i < 8; i++) {
+        double angle = angle_dist(engine);
+        Vector2 pos = {x_dist(engine), y_dist(engine)};
+        level.add_ball(pos, {0.6 * std::cos(angle), 0.6 * std::sin(angle)});
+        starts.push_back(*level.balls.back());
+    }
+    level.render_screen();
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        for (int i = 0; i < (int)level.balls.size(); i++) {
+            level.move_ball(*level.balls[i]);
+            // Balls that fall out of the well start again
+            if (level.balls[i]->outside_well(level.well)) {
+                *level.balls[i] = starts[i];
+            }
+        }
+
+        watch.start();
+        level.render_screen();
+        watch.stop();
+        ++ops;
+    }
+
+    level.destroy_objects();
+    pf.reset_render_target();
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Times Level::simulate_frame while a level is being played, to show what timing its phases costs.
+// One operation is one frame simulated.
+// level_file: The address of the level file to play.
+// profiled: Whether a FrameProfiler times the phases of every frame.
+void LevelBenchmarks::bench_simulate_frame(std::string level_file, bool profiled) {
+    std::string name = std::string("simulate_frame/") + (profiled ? "profiled/" : "plain/") + level_file;
+    if (!selected(name)) {
+        return;
+    }
+
+    FrameProfiler profiler;
+    profiler.toggle_overlay();
+    Level *level = NULL;
+    TrackingInput input;
+    bool aiming = true;
+
+    Stopwatch watch;
+    long long ops = 0;
+    while (watch.seconds() < min_seconds) {
+        // Play the level, starting it again whenever it ends
+        if (level == NULL || !level->has_ball() || level->all_bricks_destroyed()) {
+            if (level != NULL) {
+                level->destroy_objects();
+                delete level;
+            }
+            game_stat.reset_all_stats();
+            level = new Level();
+            bind(*level);
+            if (profiled) {
+                level->bind_profiler(profiler);
+            }
+            level->load_level_by_file(level_file);
+            aiming = true;
+        }
+        int ch = input.next_key(*level, aiming);
+        if (aiming) {
+            level->aim_ball(ch);
+            aiming = ch != ' ';
+            continue;
+        }
+
+        watch.start();
+        level->simulate_frame(ch);
+        profiler.end_frame(1);
+        watch.stop();
+        ++ops;
+    }
+
+    level->destroy_objects();
+    delete level;
+    results.push_back({name, ops, watch.seconds(), 0});
+}
+
+// Returns the results of every benchmark run so far.
+std::vector<BenchResult> &LevelBenchmarks::get_results() {
+    return results;
+}
+
+// Prints how to use the benchmarks.
+void print_usage() {
+    std::cerr << "Usage: benchmark [-t min_seconds] [-f filter] [-o results.csv]" << std::endl;
+    std::cerr << "Prints one CSV line per benchmark: benchmark,ops,seconds,ns_per_op,ops_per_sec" << std::endl;
+}
+
+// Writes benchmark results as CSV.
+// out: The stream to write to.
+// results: The results to write.
+void write_csv(std::ostream &out, std::vector<BenchResult> &results) {
+    out << "benchmark,ops,seconds,ns_per_op,ops_per_sec,bytes_per_op" << std::endl;
+    for (BenchResult &result : results) {
+        double ns_per_op = result.ops > 0 ? result.seconds * 1e9 / result.ops : 0;
+        double ops_per_sec = result.seconds > 0 ? result.ops / result.seconds : 0;
+        double bytes_per_op = result.ops > 0 ? (double)result.bytes / result.ops : 0;
+        out << result.name << "," << result.ops << "," << result.seconds << ","
+            << ns_per_op << "," << ops_per_sec << "," << bytes_per_op << std::endl;
+    }
+}
+
+// Runs every benchmark and prints the results.
+int main(int argc, char *argv[]) {
+    double min_seconds = 0.3;
+    std::string filter, output_file;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            print_usage();
+            return 1;
+        }
+        if (arg == "-t") {
+            min_seconds = std::atof(argv[++i]);
+        } else if (arg == "-f") {
+            filter = argv[++i];
+        } else if (arg == "-o") {
+            output_file = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    std::vector<std::string> level_files;
+    std::ifstream fin("data/index.txt");
+    std::string level_file;
+    while (fin >> level_file) {
+        level_files.push_back(level_file);
+    }
+
+    // Draw into a terminal that nobody sees, so that rendering can be timed without a screen
+    const char *term = getenv("TERM");
+    // A temporary file rather than /dev/null, so that the bytes written to it can be counted
+    FILE *terminal_out = tmpfile();
+    SCREEN *screen = newterm(term != NULL ? term : "xterm", terminal_out, stdin);
+    if (screen == NULL) {
+        screen = newterm("vt100", terminal_out, stdin);
+    }
+    if (screen == NULL) {
+        std::cerr << "Failed to set up an off-screen terminal." << std::endl;
+        return 1;
+    }
+    resize_term(50, 200);
+    start_color();
+
+    LevelBenchmarks benchmarks(min_seconds, filter, terminal_out);
+
+    int ball_counts[] = {1, 16, 256};
+    double speeds[] = {1, 4, 16};
+    for (int ball_count : ball_counts) {
+        for (double speed : speeds) {
+            benchmarks.bench_move_ball(ball_count, speed);
+        }
+    }
+    benchmarks.bench_remove_broken_block();
+    int missile_counts[] = {3, 48, 384};
+    for (int missile_count : missile_counts) {
+        benchmarks.bench_handle_missile(missile_count);
+    }
+    benchmarks.bench_draw_power_up();
+    benchmarks.bench_draw_power_ups();
+    for (std::string file : level_files) {
+        benchmarks.bench_load_level(file, false);
+        benchmarks.bench_load_level(file, true);
+    }
+    benchmarks.bench_load_generated_level(10000);
+    benchmarks.bench_open_campaign(false);
+    benchmarks.bench_open_campaign(true);
+    LevelBenchmarks::Backend backends[] = {LevelBenchmarks::WINDOW_TARGET, LevelBenchmarks::FRAME_BUFFER_TARGET, LevelBenchmarks::ANSI_TARGET};
+    for (LevelBenchmarks::Backend backend : backends) {
+        for (std::string file : {"data/default.bl", "data/boss.bl"}) {
+            benchmarks.bench_render_screen(file, true, backend);
+            benchmarks.bench_render_screen(file, false, backend);
+        }
+        benchmarks.bench_render_walls(false, backend);
+        benchmarks.bench_render_walls(true, backend);
+    }
+    benchmarks.bench_simulate_frame("data/default.bl", false);
+    benchmarks.bench_simulate_frame("data/default.bl", true);
+
+    endwin();
+    delscreen(screen);
+    fclose(terminal_out);
+
+    write_csv(std::cout, benchmarks.get_results());
+    if (output_file != "") {
+        std::ofstream fout(output_file);
+        write_csv(fout, benchmarks.get_results());
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "game_stat.h"
+#include "level.h"
+#include "level_image.h"
+#include "level_pack.h"
+#include "mapped_file.h"
+#include "playing_field.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Prints how to use the level compiler.
+void print_usage() {
+    std::cerr << "Usage: blc <level.bl> <level.blc>" << std::endl;
+    std::cerr << "       blc --pack <levels.pack> <index.txt> [text files...]" << std::endl;
+    std::cerr << "Compiles a level into a binary image that the game loads without parsing." << std::endl;
+    std::cerr << "The game uses level.blc in place of level.bl whenever it is newer." << std::endl;
+    std::cerr << "With --pack, compiles every level listed in the index, in order, into one pack along with the text files." << std::endl;
+}
+
+// Compiles a .bl level file into a level image. Returns true if the level is compiled successfully.
+// in: The address of the .bl file.
+// &image: Set to the compiled level.
+bool compile_level(std::string in, std::vector<char> &image) {
+    GameStat game_stat;
+    PlayingField pf = PlayingField({32.0, 32.0});
+    Level level;
+    level.bind_stat(game_stat);
+    level.bind_playing_field(pf);
+    try {
+        if (level.load_level_by_text(in) != 0) {
+            std::cerr << "Failed to load " << in << std::endl;
+            level.destroy_objects();
+            return false;
+        }
+    } catch (std::exception &e) {
+        std::cerr << in << ": " << e.what() << std::endl;
+        level.destroy_objects();
+        return false;
+    }
+    image = level.make_level_image();
+    level.destroy_objects();
+    return true;
+}
+
+// Compiles a .bl level file into a .blc compiled level, and checks that the result can be loaded.
+// in: The address of the .bl file.
+// out: The address of the .blc file.
+int compile_level_file(std::string in, std::string out) {
+    std::vector<char> image;
+    if (!compile_level(in, image)) {
+        return 1;
+    }
+    std::ofstream fout(out, std::ios::binary);
+    fout.write(image.data(), image.size());
+    fout.close();
+    if (fout.fail()) {
+        std::cerr << "Failed to write " << out << std::endl;
+        return 1;
+    }
+
+    MappedFile written;
+    std::string error;
+    if (!written.open(out) || !check_level_image(written.data(), written.size(), error)) {
+        std::cerr << out << ": " << error << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Builds a level pack from every level in an index file and some text files, and checks that it can be opened.
+// out: The address of the pack.
+// index: The address of the index file, which lists the level files in the order they are played.
+// text_files: The addresses of the text files to add.
+int build_pack(std::string out, std::string index, std::vector<std::string> text_files) {
+    std::ifstream fin(index);
+    if (fin.fail()) {
+        std::cerr << "Failed to open " << index << std::endl;
+        return 1;
+    }
+
+    std::vector<LevelPackItem> items;
+    std::string level_file;
+    while (fin >> level_file) {
+        LevelPackItem item = {level_file, LevelPack::LEVEL, std::vector<char>()};
+        if (!compile_level(level_file, item.contents)) {
+            return 1;
+        }
+        items.push_back(item);
+    }
+    for (std::string text_file : text_files) {
+        std::ifstream text(text_file, std::ios::binary);
+        if (text.fail()) {
+            std::cerr << "Failed to open " << text_file << std::endl;
+            return 1;
+        }
+        LevelPackItem item = {text_file, LevelPack::TEXT, std::vector<char>()};
+        item.contents.assign(std::istreambuf_iterator<char>(text), std::istreambuf_iterator<char>());
+        items.push_back(item);
+    }
+
+    if (!LevelPack::write(out, items)) {
+        std::cerr << "Failed to write " << out << " (names must be shorter than 56 characters)" << std::endl;
+        return 1;
+    }
+
+    LevelPack pack;
+    if (!pack.open(out)) {
+        std::cerr << out << ": the written pack cannot be opened" << std::endl;
+        return 1;
+    }
+    for (LevelPackItem &item : items) {
+        const char *data;
+        size_t size;
+        if (!pack.read(item.name, data, size)) {
+            std::cerr << out << ": " << item.name << " is damaged" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Compiles a level, or every level of a campaign into a pack.
+int main(int argc, char *argv[]) {
+    if (argc >= 4 && std::string(argv[1]) == "--pack") {
+        return build_pack(argv[2], argv[3], std::vector<std::string>(argv + 4, argv + argc));
+    }
+    if (argc != 3) {
+        print_usage();
+        return 1;
+    }
+    return compile_level_file(argv[1], argv[2]);
+}
@@ -0,0 +1,108 @@
+#include "brick_grid.h"
+#include "rect.h"
+#include "brick_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Constructs an empty grid.
+// bounds: The area covered by the grid. Anything outside of it is put in the nearest cell on the edge.
+// cell_size: The width and height of each cell.
+BrickGrid::BrickGrid(Rect bounds, double cell_size) {
+    BrickGrid::bounds = bounds;
+    BrickGrid::cell_size = cell_size;
+    cols = std::max(1, (int)std::ceil((bounds.pos2.x - bounds.pos1.x) / cell_size));
+    rows = std::max(1, (int)std::ceil((bounds.pos2.y - bounds.pos1.y) / cell_size));
+    cells.resize(cols * rows);
+}
+
+// Returns the column of the cell containing an x-coordinate, clamped to the grid.
+// x: The x-coordinate.
+int BrickGrid::col_x(double x) {
+    int c = (int)std::floor((x - bounds.pos1.x) / cell_size);
+    return std::min(std::max(c, 0), cols - 1);
+}
+
+// Returns the row of the cell containing a y-coordinate, clamped to the grid.
+// y: The y-coordinate.
+int BrickGrid::row_y(double y) {
+    int r = (int)std::floor((y - bounds.pos1.y) / cell_size);
+    return std::min(std::max(r, 0), rows - 1);
+}
+
+// Returns the range of cells (inclusive) that overlap an area.
+// area: The area to look up.
+// &c1, &c2, &r1, &r2: Outputs, the first and last columns and rows.
+void BrickGrid::get_cell_range(Rect area, int &c1, int &c2, int &r1, int &r2) {
+    c1 = col_x(area.pos1.x);
+    c2 = col_x(area.pos2.x);
+    r1 = row_y(area.pos1.y);
+    r2 = row_y(area.pos2.y);
+}
+
+// Clears the grid and adds every brick in a table to it.
+// bricks: The bricks to add.
+void BrickGrid::build(BrickTable &bricks) {
+    clear();
+    for (int id = 0; id < bricks.slot_count(); id++) {
+        if (bricks.exists(id)) {
+            insert(id, bricks.get_rect(id));
+        }
+    }
+}
+
+// Adds a brick to every cell that it overlaps.
+// id: The id of the brick to add.
+// rect: The rect that the brick occupies.
+void BrickGrid::insert(int id, Rect rect) {
+    int c1, c2, r1, r2;
+    get_cell_range(rect, c1, c2, r1, r2);
+    for (int r = r1; r <= r2; r++) {
+        for (int c = c1; c <= c2; c++) {
+            cells[r * cols + c].push_back(id);
+        }
+    }
+}
+
+// Removes a brick from every cell that it overlaps.
+// id: The id of the brick to remove.
+// rect: The rect that the brick occupies.
+void BrickGrid::remove(int id, Rect rect) {
+    int c1, c2, r1, r2;
+    get_cell_range(rect, c1, c2, r1, r2);
+    for (int r = r1; r <= r2; r++) {
+        for (int c = c1; c <= c2; c++) {
+            std::vector<int> &cell = cells[r * cols + c];
+            cell.erase(std::remove(cell.begin(), cell.end(), id), cell.end());
+        }
+    }
+}
+
+// Removes every brick from the grid.
+void BrickGrid::clear() {
+    for (std::vector<int> &cell : cells) {
+        cell.clear();
+    }
+}
+
+// Finds the bricks in the cells that overlap an area. Each brick appears once.
+// The bricks are returned in order of their ids.
+// Note that the bricks found are only near the area, and may not actually touch it.
+// area: The area to look up.
+// found: Output, the ids of the bricks near the area. Its previous contents are discarded.
+void BrickGrid::query(Rect area, std::vector<int> &found) {
+    found.clear();
+
+    int c1, c2, r1, r2;
+    get_cell_range(area, c1, c2, r1, r2);
+    for (int r = r1; r <= r2; r++) {
+        for (int c = c1; c <= c2; c++) {
+            std::vector<int> &cell = cells[r * cols + c];
+            found.insert(found.end(), cell.begin(), cell.end());
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+}
@@ -0,0 +1,34 @@
+#include "rect.h"
+#include "brick_table.h"
+
+#include <vector>
+
+#ifndef BRICK_GRID_H_
+#define BRICK_GRID_H_
+
+// A uniform grid over the playing field, used to quickly find the bricks near a point or an area.
+// Each cell keeps a list of the ids of the bricks that overlap it, so a query only looks at the cells it touches
+// instead of every brick in the level.
+class BrickGrid {
+    public:
+        BrickGrid(Rect bounds, double cell_size);
+
+        void build(BrickTable &bricks);
+        void insert(int id, Rect rect);
+        void remove(int id, Rect rect);
+        void clear();
+
+        void query(Rect area, std::vector<int> &found);
+
+    private:
+        Rect bounds;
+        double cell_size;
+        int cols, rows;
+        std::vector<std::vector<int>> cells;
+
+        int col_x(double x);
+        int row_y(double y);
+        void get_cell_range(Rect area, int &c1, int &c2, int &r1, int &r2);
+};
+
+#endif
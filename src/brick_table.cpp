@@ -0,0 +1,189 @@
+#include "brick_table.h"
+#include "playing_field.h"
+#include "rect.h"
+#include "rect_wall.h"
+
+#include <vector>
+
+// Adds a brick and returns its id.
+// rect: The rectangle that the brick occupies.
+// clr0: The id of the color of the brick.
+// unbreakable: If true, the brick is a wall. It is drawn filled and can never be broken.
+// points: Points given when the brick is broken.
+int BrickTable::add(Rect rect, int clr0, bool unbreakable, int points) {
+    RectWall look(rect, clr0);
+    if (unbreakable) {
+        look.set_draw_pattern(1);
+    }
+    unsigned char state = EXISTS | (unbreakable ? UNBREAKABLE : 0);
+    ++brick_count;
+    if (!unbreakable) {
+        ++breakable_count;
+    }
+
+    if (!free_slots.empty()) {
+        int id = free_slots.back();
+        free_slots.pop_back();
+        rects[id] = rect;
+        states[id] = state;
+        looks[id] = look;
+        BrickTable::points[id] = points;
+        return id;
+    }
+
+    rects.push_back(rect);
+    states.push_back(state);
+    looks.push_back(look);
+    BrickTable::points.push_back(points);
+    return rects.size() - 1;
+}
+
+// Adds a grid of bricks.
+// subject_rect: The size of the bottom-left brick.
+// x_separation: The horizontal separation of each bricks' center.
+// y_separation: The vertical separation of each bricks' center.
+// col_count: The number of columns.
+// row_count: The number of rows.
+// clr0: The id of the color of the brick.
+void BrickTable::add_grid(Rect subject_rect, double x_separation, double y_separation, int col_count, int row_count, int clr0) {
+    for (int i = 0; i < col_count; i++) {
+        for (int j = 0; j < row_count; j++) {
+            add(subject_rect.translate({x_separation * i, y_separation * j}), clr0, false);
+        }
+    }
+}
+
+// Removes a brick. Its id may be given to a brick added later.
+// id: The id of the brick to remove.
+void BrickTable::remove(int id) {
+    if (exists(id)) {
+        --brick_count;
+        if (!is_unbreakable(id)) {
+            --breakable_count;
+        }
+        states[id] = 0;
+        free_slots.push_back(id);
+    }
+}
+
+// Removes every brick.
+void BrickTable::clear() {
+    rects.clear();
+    states.clear();
+    looks.clear();
+    points.clear();
+    free_slots.clear();
+    broken_queue.clear();
+    brick_count = 0;
+    breakable_count = 0;
+}
+
+// Makes room for a number of bricks in total, so that adding up to that many bricks does not reallocate.
+// count: The number of bricks to make room for.
+void BrickTable::reserve(int count) {
+    rects.reserve(count);
+    states.reserve(count);
+    looks.reserve(count);
+    points.reserve(count);
+}
+
+// Makes room in the broken queue and the free slots for every brick there is, so that breaking and removing
+// bricks does not allocate.
+void BrickTable::reserve_queues() {
+    broken_queue.reserve(slot_count());
+    free_slots.reserve(slot_count());
+}
+
+// Breaks the brick. What actually happens is that the "broken" flag is set to true,
+// and the brick is added to the broken queue. The game will then later remove the bricks in the queue.
+// Returns true if the brick has just been broken, false if it is unbreakable or already broken.
+// id: The id of the brick to break.
+bool BrickTable::break_brick(int id) {
+    if ((states[id] & (EXISTS | BROKEN | UNBREAKABLE)) != EXISTS) {
+        return false;
+    }
+    states[id] |= BROKEN;
+    broken_queue.push_back(id);
+    return true;
+}
+
+// Returns the ids of the bricks broken since the queue was last cleared, in the order they were broken.
+const std::vector<int> &BrickTable::get_broken_queue() {
+    return broken_queue;
+}
+
+// Empties the broken queue, once the bricks in it have been dealt with. Its memory is kept for reuse.
+void BrickTable::clear_broken_queue() {
+    broken_queue.clear();
+}
+
+// Returns the number of slots, i.e. one more than the largest id in use.
+// Loop over 0 <= id < slot_count() and skip the ids that do not exist to visit every brick.
+int BrickTable::slot_count() {
+    return rects.size();
+}
+
+// Returns if there is a brick with this id.
+bool BrickTable::exists(int id) {
+    return id >= 0 && id < slot_count() && (states[id] & EXISTS);
+}
+
+// Returns if the brick has been broken, but has not been removed yet.
+bool BrickTable::is_broken(int id) {
+    return states[id] & BROKEN;
+}
+
+// Returns if the brick is a wall, which cannot be broken.
+bool BrickTable::is_unbreakable(int id) {
+    return states[id] & UNBREAKABLE;
+}
+
+// Returns the rect that the brick occupies.
+Rect BrickTable::get_rect(int id) {
+    return rects[id];
+}
+
+// Returns the points given when the brick is broken.
+int BrickTable::get_points(int id) {
+    return points[id];
+}
+
+// Returns the id of the color of the brick.
+int BrickTable::get_color(int id) {
+    return looks[id].get_color();
+}
+
+// Returns the number of bricks, including walls.
+int BrickTable::count_bricks() {
+    return brick_count;
+}
+
+// Returns the number of bricks that can still be broken, including broken ones that have not been removed yet.
+int BrickTable::count_breakable() {
+    return breakable_count;
+}
+
+// Draws every brick on the screen.
+// pfield: The playing field to draw on.
+void BrickTable::draw_to_pf(PlayingField &pfield) {
+    for (int id = 0; id < slot_count(); id++) {
+        if (states[id] & EXISTS) {
+            looks[id].draw_to_pf(pfield);
+        }
+    }
+}
+
+// Draws one brick on the screen.
+// id: The brick to draw.
+// pfield: The playing field to draw on.
+void BrickTable::draw_brick(int id, PlayingField &pfield) {
+    looks[id].draw_to_pf(pfield);
+}
+
+// Draws the part of one brick that lies inside the given cells.
+// id: The brick to draw.
+// pfield: The playing field to draw on.
+// clip: The cells to draw in.
+void BrickTable::draw_brick(int id, PlayingField &pfield, CellBox clip) {
+    looks[id].draw_to_pf(pfield, clip);
+}
@@ -0,0 +1,63 @@
+#include "playing_field.h"
+#include "rect.h"
+#include "rect_wall.h"
+
+#include <vector>
+
+#ifndef BRICK_TABLE_H_
+#define BRICK_TABLE_H_
+
+// Stores every brick in a level in contiguous arrays, one entry (slot) per brick.
+// A brick is referred to by its slot index (its id), which never changes while the brick exists.
+// Removed slots are reused by bricks added later.
+//
+// The data read by collision checks every frame (the rect and the state flags) is kept apart
+// from the data only needed for drawing and scoring, so that collision scans stay compact.
+class BrickTable {
+    public:
+        int add(Rect rect, int clr0, bool unbreakable, int points = 100);
+        void add_grid(Rect subject_rect, double x_separation, double y_separation, int col_count, int row_count, int clr0 = 32);
+        void remove(int id);
+        void clear();
+        void reserve(int count);
+        void reserve_queues();
+
+        bool break_brick(int id);
+        const std::vector<int> &get_broken_queue();
+        void clear_broken_queue();
+
+        int slot_count();
+        bool exists(int id);
+        bool is_broken(int id);
+        bool is_unbreakable(int id);
+        Rect get_rect(int id);
+        int get_points(int id);
+        int get_color(int id);
+
+        int count_bricks();
+        int count_breakable();
+        void draw_to_pf(PlayingField &pfield);
+        void draw_brick(int id, PlayingField &pfield);
+        void draw_brick(int id, PlayingField &pfield, CellBox clip);
+
+    private:
+        enum State { EXISTS = 1, BROKEN = 2, UNBREAKABLE = 4 };
+
+        // Hot data, read by every collision check.
+        std::vector<Rect> rects;
+        std::vector<unsigned char> states;
+
+        // Cold data, read when a brick is drawn or broken.
+        std::vector<RectWall> looks;
+        std::vector<int> points;
+
+        std::vector<int> free_slots;
+
+        // Live counts, updated whenever a brick is added or removed.
+        int brick_count = 0, breakable_count = 0;
+
+        // Ids of the bricks broken since the queue was last cleared, in the order they were broken.
+        std::vector<int> broken_queue;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "curses_target.h"
+#include "ncu.h"
+
+#include <algorithm>
+
+// Constructs a target that draws to an ncurses window.
+// window: The window. ncurses has to be initialized before anything is drawn to it.
+CursesTarget::CursesTarget(WINDOW *window) {
+    CursesTarget::window = window;
+}
+
+// Sets the color pair of everything drawn after this.
+// color_pair: The color pair, or 0 for the default colors.
+void CursesTarget::set_color(int color_pair) {
+    wattrset(window, COLOR_PAIR(color_pair));
+}
+
+// Draws a character in a cell.
+// r, c: The row and column of the cell.
+// ch: The character.
+void CursesTarget::put_char(int r, int c, char ch) {
+    mvwaddch(window, r, c, (unsigned char)ch);
+}
+
+// Draws a string from a cell to the right.
+// r, c: The row and column of the first character.
+// str: The string.
+void CursesTarget::put_string(int r, int c, const char *str) {
+    mvwaddstr(window, r, c, str);
+}
+
+// Draws a character in a number of cells from a cell to the right.
+// r, c: The row and column of the first cell.
+// ch: The character.
+// count: The number of cells.
+void CursesTarget::fill_row(int r, int c, char ch, int count) {
+    wmove(window, r, c);
+    whline(window, (unsigned char)ch, count);
+}
+
+// Draws a character in a number of cells from a cell downwards.
+// r, c: The row and column of the first cell.
+// ch: The character.
+// count: The number of cells.
+void CursesTarget::fill_column(int r, int c, char ch, int count) {
+    wmove(window, r, c);
+    wvline(window, (unsigned char)ch, count);
+}
+
+// Draws a row of cells, each with its own character and color pair, from a cell to the right.
+// The cells are written straight into the window a block at a time, without moving the cursor.
+// r, c: The row and column of the first cell.
+// chars: The characters.
+// colors: The color pairs.
+// count: The number of cells.
+void CursesTarget::put_cells(int r, int c, const char *chars, const int *colors, int count) {
+    const int block_size = 256;
+    chtype block[block_size];
+    for (int begin = 0; begin < count; begin += block_size) {
+        int size = std::min(count - begin, block_size);
+        for (int i = 0; i < size; i++) {
+            block[i] = (unsigned char)chars[begin + i] | COLOR_PAIR(colors[begin + i]);
+        }
+        mvwaddchnstr(window, r, c + begin, block, size);
+    }
+}
+
+// Clears the window.
+void CursesTarget::clear() {
+    werase(window);
+}
+
+// Sends the changes in the window to the terminal, together with every other window staged with wnoutrefresh()
+// during the frame (the game stats and the notification bar), in one update.
+void CursesTarget::present() {
+    wnoutrefresh(window);
+    doupdate();
+}
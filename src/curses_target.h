@@ -0,0 +1,27 @@
+#include "ncu.h"
+#include "render_target.h"
+
+#include <cstddef>
+
+#ifndef CURSES_TARGET_H_
+#define CURSES_TARGET_H_
+
+// Draws to an ncurses window.
+class CursesTarget : public RenderTarget {
+    public:
+        CursesTarget(WINDOW *window = NULL);
+
+        void set_color(int color_pair);
+        void put_char(int r, int c, char ch);
+        void put_string(int r, int c, const char *str);
+        void fill_row(int r, int c, char ch, int count);
+        void fill_column(int r, int c, char ch, int count);
+        void put_cells(int r, int c, const char *chars, const int *colors, int count);
+        void clear();
+        void present();
+
+    private:
+        WINDOW *window;
+};
+
+#endif
@@ -0,0 +1,208 @@
+#include "frame_buffer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Constructs a frame buffer with every cell blank.
+// rows, cols: The size of the frame buffer.
+FrameBuffer::FrameBuffer(int rows, int cols) : rows(rows), cols(cols), chars(rows * cols, ' '), colors(rows * cols, 0) {}
+
+// Sets the color pair of everything drawn after this.
+// color_pair: The color pair, or 0 for the default colors.
+void FrameBuffer::set_color(int color_pair) {
+    color = color_pair;
+}
+
+// Draws a character in a cell. Cells outside the frame buffer are ignored.
+// r, c: The row and column of the cell.
+// ch: The character.
+void FrameBuffer::put_char(int r, int c, char ch) {
+    if (r < 0 || r >= rows || c < 0 || c >= cols) {
+        return;
+    }
+    chars[r * cols + c] = ch;
+    colors[r * cols + c] = color;
+}
+
+// Draws a string from a cell to the right. The part that does not fit in the row is cut off.
+// r, c: The row and column of the first character.
+// str: The string.
+void FrameBuffer::put_string(int r, int c, const char *str) {
+    for (int i = 0; str[i] != '\0'; i++) {
+        put_char(r, c + i, str[i]);
+    }
+}
+
+// Draws a character in a number of cells from a cell to the right.
+// r, c: The row and column of the first cell.
+// ch: The character.
+// count: The number of cells.
+void FrameBuffer::fill_row(int r, int c, char ch, int count) {
+    if (r < 0 || r >= rows) {
+        return;
+    }
+    int begin = std::max(c, 0), end = std::min(c + count, cols);
+    if (begin >= end) {
+        return;
+    }
+    std::fill(chars.begin() + r * cols + begin, chars.begin() + r * cols + end, ch);
+    std::fill(colors.begin() + r * cols + begin, colors.begin() + r * cols + end, color);
+}
+
+// Draws a character in a number of cells from a cell downwards.
+// r, c: The row and column of the first cell.
+// ch: The character.
+// count: The number of cells.
+void FrameBuffer::fill_column(int r, int c, char ch, int count) {
+    for (int i = 0; i < count; i++) {
+        put_char(r + i, c, ch);
+    }
+}
+
+// Draws a row of cells, each with its own character and color pair, from a cell to the right.
+// The part that does not fit in the row is cut off.
+// r, c: The row and column of the first cell.
+// chars: The characters.
+// colors: The color pairs.
+// count: The number of cells.
+void FrameBuffer::put_cells(int r, int c, const char *chars, const int *colors, int count) {
+    if (r < 0 || r >= rows) {
+        return;
+    }
+    int begin = std::max(c, 0), end = std::min(c + count, cols);
+    if (begin >= end) {
+        return;
+    }
+    std::copy(chars + (begin - c), chars + (end - c), FrameBuffer::chars.begin() + r * cols + begin);
+    std::copy(colors + (begin - c), colors + (end - c), FrameBuffer::colors.begin() + r * cols + begin);
+}
+
+// Clears every cell to a blank with the default colors.
+void FrameBuffer::clear() {
+    std::fill(chars.begin(), chars.end(), ' ');
+    std::fill(colors.begin(), colors.end(), 0);
+}
+
+// Does nothing, as there is no screen to show the frame on.
+void FrameBuffer::present() {}
+
+// Returns the number of rows.
+int FrameBuffer::get_rows() {
+    return rows;
+}
+
+// Returns the number of columns.
+int FrameBuffer::get_cols() {
+    return cols;
+}
+
+// Returns the character in a cell.
+// r, c: The row and column of the cell. It must be inside the frame buffer.
+char FrameBuffer::get_char(int r, int c) {
+    return chars.at(r * cols + c);
+}
+
+// Returns the color pair of a cell.
+// r, c: The row and column of the cell. It must be inside the frame buffer.
+int FrameBuffer::get_color(int r, int c) {
+    return colors.at(r * cols + c);
+}
+
+// Returns the first column from c on where a row differs from the same row of another frame buffer,
+// or the number of columns if the rest of the row is the same.
+// other: The other frame buffer. It must be the same size.
+// r: The row.
+// c: The column to start from.
+int FrameBuffer::find_change(FrameBuffer &other, int r, int c) {
+    const char *chars_a = chars.data() + r * cols;
+    const char *chars_b = other.chars.data() + r * cols;
+    const int *colors_a = colors.data() + r * cols;
+    const int *colors_b = other.colors.data() + r * cols;
+    while (c < cols && chars_a[c] == chars_b[c] && colors_a[c] == colors_b[c]) {
+        c++;
+    }
+    return c;
+}
+
+// Draws a block of this frame buffer's cells onto another target at the same rows and columns, one row at a time.
+// The part of the block outside this frame buffer is left out.
+// target: The target to draw on.
+// r1, r2: The starting and ending rows.
+// c1, c2: The starting and ending columns.
+void FrameBuffer::copy_to(RenderTarget &target, int r1, int r2, int c1, int c2) {
+    r1 = std::max(r1, 0);
+    r2 = std::min(r2, rows - 1);
+    c1 = std::max(c1, 0);
+    c2 = std::min(c2, cols - 1);
+    if (c1 > c2) {
+        return;
+    }
+    for (int r = r1; r <= r2; r++) {
+        target.put_cells(r, c1, chars.data() + r * cols + c1, colors.data() + r * cols + c1, c2 - c1 + 1);
+    }
+}
+
+// Returns the character that stands for a color pair in the text of a frame:
+// 0-9, then a-z and A-Z for pairs 10 to 61, and '?' for any other pair.
+// color_pair: The color pair.
+char FrameBuffer::get_color_code(int color_pair) {
+    static const char codes[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    if (color_pair < 0 || color_pair >= (int)sizeof(codes) - 1) {
+        return '?';
+    }
+    return codes[color_pair];
+}
+
+// Returns the frame as text: the rows of characters, an empty line, and then the rows of color pairs.
+std::string FrameBuffer::to_text() {
+    std::string text;
+    text.reserve(2 * rows * (cols + 1) + 1);
+    for (int r = 0; r < rows; r++) {
+        text.append(chars.begin() + r * cols, chars.begin() + (r + 1) * cols);
+        text += '\n';
+    }
+    text += '\n';
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            text += get_color_code(colors[r * cols + c]);
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+// Writes the frame to a file as text. Throws a runtime error if the file cannot be written.
+// filename: The address of the file.
+void FrameBuffer::save(std::string filename) {
+    std::ofstream fout(filename);
+    fout << to_text();
+    if (fout.fail()) {
+        throw std::runtime_error("Failed to write " + filename);
+    }
+}
+
+// Compares the frame to one saved with save(). Returns the line of the file where they first differ
+// (starting from 1), or 0 if they are the same. Throws a runtime error if the file cannot be opened.
+// filename: The address of the file.
+int FrameBuffer::compare_to_file(std::string filename) {
+    std::ifstream fin(filename);
+    if (fin.fail()) {
+        throw std::runtime_error("Failed to open " + filename);
+    }
+    std::stringstream actual(to_text());
+
+    std::string expected_line, actual_line;
+    for (int line = 1;; line++) {
+        bool has_expected = (bool)std::getline(fin, expected_line);
+        bool has_actual = (bool)std::getline(actual, actual_line);
+        if (!has_expected && !has_actual) {
+            return 0;
+        }
+        if (has_expected != has_actual || expected_line != actual_line) {
+            return line;
+        }
+    }
+}
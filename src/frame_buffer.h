@@ -0,0 +1,47 @@
+#include "render_target.h"
+
+#include <string>
+#include <vector>
+
+#ifndef FRAME_BUFFER_H_
+#define FRAME_BUFFER_H_
+
+// Keeps the character and color pair of every cell in memory, instead of drawing to a terminal.
+// present() does nothing, so only the cost of drawing itself is left to time.
+//
+// A frame can be written out as text and compared against a saved (golden) frame. The text is every row of
+// characters, then an empty line, then every row of color pairs with one code per cell (see get_color_code()).
+class FrameBuffer : public RenderTarget {
+    public:
+        FrameBuffer(int rows, int cols);
+
+        void set_color(int color_pair);
+        void put_char(int r, int c, char ch);
+        void put_string(int r, int c, const char *str);
+        void fill_row(int r, int c, char ch, int count);
+        void fill_column(int r, int c, char ch, int count);
+        void put_cells(int r, int c, const char *chars, const int *colors, int count);
+        void clear();
+        void present();
+
+        int get_rows();
+        int get_cols();
+        char get_char(int r, int c);
+        int get_color(int r, int c);
+        int find_change(FrameBuffer &other, int r, int c);
+        void copy_to(RenderTarget &target, int r1, int r2, int c1, int c2);
+
+        std::string to_text();
+        void save(std::string filename);
+        int compare_to_file(std::string filename);
+
+    private:
+        int rows, cols;
+        int color = 0;
+        std::vector<char> chars;
+        std::vector<int> colors;
+
+        static char get_color_code(int color_pair);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "frame_clock.h"
+
+#include <chrono>
+#include <thread>
+
+// Constructs a frame clock.
+// period_ms: The length of one tick in milliseconds. The default, 33, is about 30 ticks per second.
+// max_catch_up: The most ticks run at once after a late frame. Anything more behind than this is skipped,
+// so that a long stall (e.g. the terminal hanging) does not make the game race ahead afterwards.
+FrameClock::FrameClock(int period_ms, int max_catch_up) {
+    period = std::chrono::milliseconds(period_ms);
+    FrameClock::max_catch_up = max_catch_up;
+    start();
+}
+
+// Starts counting ticks from now. Call this after anything that stops the game for a while, like a menu.
+void FrameClock::start() {
+    next_deadline = std::chrono::steady_clock::now() + period;
+}
+
+// Sleeps until the next tick is due, and returns how many ticks should be simulated before the next draw.
+// This is 1 when the game keeps up. When the last frame took too long, the deadlines that were missed
+// are counted and their ticks are returned too (up to max_catch_up).
+int FrameClock::wait_for_frame() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < next_deadline) {
+        std::this_thread::sleep_until(next_deadline);
+        next_deadline += period;
+        return 1;
+    }
+
+    // Every whole period since the deadline is a tick that was not run in time.
+    int late_ticks = (now - next_deadline) / period;
+    missed_deadlines += late_ticks + 1;
+
+    int ticks = late_ticks + 1;
+    if (ticks > max_catch_up) {
+        ticks = max_catch_up;
+        next_deadline = now + period;
+    } else {
+        next_deadline += period * ticks;
+    }
+    return ticks;
+}
+
+// Returns the number of deadlines missed since the count was last reset.
+int FrameClock::get_missed_deadlines() {
+    return missed_deadlines;
+}
+
+// Resets the number of missed deadlines to 0.
+void FrameClock::reset_missed_deadlines() {
+    missed_deadlines = 0;
+}
@@ -0,0 +1,36 @@
+#include <chrono>
+
+#ifndef FRAME_CLOCK_H_
+#define FRAME_CLOCK_H_
+
+// Keeps the game running at a fixed number of simulation steps (ticks) per second,
+// however long each frame takes to simulate and draw.
+//
+// Deadlines are absolute: the n-th tick is due at start + n * period, so time spent working
+// is not added on top of the wait and the frame rate does not drift. If a frame runs late,
+// the ticks that were missed are run before the next draw, so the game speed stays the same.
+class FrameClock {
+    public:
+        FrameClock(int period_ms = 33, int max_catch_up = 5);
+
+        void start();
+        int wait_for_frame();
+
+        int get_max_catch_up();
+        int get_missed_deadlines();
+        void reset_missed_deadlines();
+
+    private:
+        std::chrono::steady_clock::duration period;
+        std::chrono::steady_clock::time_point next_deadline;
+        int max_catch_up;
+        int missed_deadlines = 0;
+};
+
+// Returns the most ticks that a frame can have.
+// Inline, so that the simulation can size its key buffers without linking the clock.
+inline int FrameClock::get_max_catch_up() {
+    return max_catch_up;
+}
+
+#endif
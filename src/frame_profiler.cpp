@@ -0,0 +1,132 @@
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+// Constructs a profiler that is not enabled yet.
+// window: The number of frames that the means and maxes are taken over.
+// report_period: The number of frames between updates of the means and maxes.
+FrameProfiler::FrameProfiler(int window, int report_period)
+    : samples(window * PHASE_COUNT, 0), window(window), report_period(report_period) {
+    std::fill(frame_times, frame_times + PHASE_COUNT, std::chrono::steady_clock::duration::zero());
+    std::fill(mean_us, mean_us + PHASE_COUNT, 0.0);
+    std::fill(max_us, max_us + PHASE_COUNT, 0.0);
+}
+
+// Returns the short name of a phase, as shown on the overlay and in the CSV header.
+// phase: The phase.
+const char *FrameProfiler::get_phase_name(Phase phase) {
+    switch (phase) {
+    case WAIT:
+        return "wait";
+    case INPUT:
+        return "input";
+    case MOVE_BALLS:
+        return "ball";
+    case HANDLE_MISSILE:
+        return "missile";
+    case REMOVE_BRICKS:
+        return "brick";
+    case HANDLE_POWER_UPS:
+        return "power_up";
+    case TICK_TIMERS:
+        return "timer";
+    case RENDER:
+        return "render";
+    default:
+        return "";
+    }
+}
+
+// Ends the current frame: adds its phase times to the last frames, and writes them to the CSV file if one is open.
+// ticks: The number of ticks simulated in the frame.
+void FrameProfiler::end_frame(int ticks) {
+    if (!is_enabled()) {
+        return;
+    }
+
+    long long *frame_samples = &samples[(frames % window) * PHASE_COUNT];
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        frame_samples[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(frame_times[i]).count();
+        frame_times[i] = std::chrono::steady_clock::duration::zero();
+    }
+
+    if (csv.is_open()) {
+        csv << frames << "," << ticks;
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            csv << "," << frame_samples[i] / 1000.0;
+        }
+        csv << "\n";
+    }
+
+    if (++frames % report_period == 0) {
+        make_report();
+        // So that a game that is killed still leaves most of its frames behind
+        csv.flush();
+    }
+}
+
+// Works out the mean and max of each phase over the last frames.
+void FrameProfiler::make_report() {
+    int count = std::min(frames, window);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        long long total = 0, max = 0;
+        for (int frame = 0; frame < count; frame++) {
+            long long sample = samples[frame * PHASE_COUNT + i];
+            total += sample;
+            max = std::max(max, sample);
+        }
+        mean_us[i] = total / 1000.0 / count;
+        max_us[i] = max / 1000.0;
+    }
+    ++report_count;
+}
+
+// Shows the overlay if it is hidden, and hides it if it is shown.
+// Showing the overlay starts the means and maxes over, so that they do not include the frames before.
+void FrameProfiler::toggle_overlay() {
+    shown = !shown;
+    if (shown && !csv.is_open()) {
+        frames = 0;
+        std::fill(frame_times, frame_times + PHASE_COUNT, std::chrono::steady_clock::duration::zero());
+    }
+}
+
+// Returns if the overlay is shown.
+bool FrameProfiler::overlay_shown() {
+    return shown;
+}
+
+// Writes the phase times of every frame from then on to a CSV file, one line per frame, in microseconds.
+// Throws a runtime error if the file cannot be opened.
+// filename: The address of the file. It is overwritten.
+void FrameProfiler::open_csv(std::string filename) {
+    csv.open(filename);
+    if (csv.fail()) {
+        throw std::runtime_error("Failed to open " + filename + " for profiling.");
+    }
+    csv << "frame,ticks";
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        csv << "," << get_phase_name((Phase)i) << "_us";
+    }
+    csv << "\n";
+}
+
+// Returns the mean time spent in a phase per frame, in microseconds, as of the last report.
+// phase: The phase.
+double FrameProfiler::get_mean_us(Phase phase) {
+    return mean_us[phase];
+}
+
+// Returns the longest time spent in a phase in a frame, in microseconds, as of the last report.
+// phase: The phase.
+double FrameProfiler::get_max_us(Phase phase) {
+    return max_us[phase];
+}
+
+// Returns the number of reports made so far. The means and maxes only change when this does.
+int FrameProfiler::get_report_count() {
+    return report_count;
+}
@@ -0,0 +1,117 @@
+#include "trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef FRAME_PROFILER_H_
+#define FRAME_PROFILER_H_
+
+// Measures how long each phase of a frame takes, to find out what makes a frame slow.
+// Phases are timed with a ScopedPhase, and a phase that runs more than once in a frame (e.g. once per tick)
+// adds up. Keeps the mean and max of each phase over the last frames, and can write every frame to a CSV file.
+//
+// Timing only happens while it is enabled, i.e. while its overlay is shown or a CSV file is open,
+// so that an idle profiler costs one check per phase.
+class FrameProfiler {
+    public:
+        enum Phase {
+            WAIT,
+            INPUT,
+            MOVE_BALLS,
+            HANDLE_MISSILE,
+            REMOVE_BRICKS,
+            HANDLE_POWER_UPS,
+            TICK_TIMERS,
+            RENDER,
+            PHASE_COUNT
+        };
+
+        FrameProfiler(int window = 60, int report_period = 15);
+
+        static const char *get_phase_name(Phase phase);
+
+        bool is_enabled();
+        void add_time(Phase phase, std::chrono::steady_clock::duration time);
+        void end_frame(int ticks);
+
+        void toggle_overlay();
+        bool overlay_shown();
+        void open_csv(std::string filename);
+
+        double get_mean_us(Phase phase);
+        double get_max_us(Phase phase);
+        int get_report_count();
+
+    private:
+        // The time spent in each phase in the current frame.
+        std::chrono::steady_clock::duration frame_times[PHASE_COUNT];
+        // The times of the last window frames in a ring, PHASE_COUNT times per frame, in nanoseconds.
+        std::vector<long long> samples;
+        int window, report_period;
+        int frames = 0;
+
+        // The means and maxes as of the last report, which is made every report_period frames
+        // so that the overlay changes slowly enough to be read.
+        double mean_us[PHASE_COUNT], max_us[PHASE_COUNT];
+        int report_count = 0;
+
+        bool shown = false;
+        std::ofstream csv;
+
+        void make_report();
+};
+
+// Times one phase of a frame, from its construction to the end of its scope, and adds it to a FrameProfiler.
+// While events are being traced (see trace.h), the phase is also recorded as a span.
+class ScopedPhase {
+    public:
+        ScopedPhase(FrameProfiler *profiler, FrameProfiler::Phase phase);
+        ~ScopedPhase();
+
+    private:
+        FrameProfiler *profiler;
+        FrameProfiler::Phase phase;
+        bool traced;
+        std::chrono::steady_clock::time_point start;
+};
+
+// Returns if phases are being timed.
+inline bool FrameProfiler::is_enabled() {
+    return shown || csv.is_open();
+}
+
+// Adds the time spent in a phase to the current frame.
+// phase: The phase.
+// time: The time spent.
+inline void FrameProfiler::add_time(Phase phase, std::chrono::steady_clock::duration time) {
+    frame_times[phase] += time;
+}
+
+// Starts timing a phase.
+// profiler: The FrameProfiler to add the time to, or NULL. The time is not added if it is not enabled.
+// phase: The phase.
+inline ScopedPhase::ScopedPhase(FrameProfiler *profiler, FrameProfiler::Phase phase) : phase(phase) {
+    ScopedPhase::profiler = (profiler != NULL && profiler->is_enabled()) ? profiler : NULL;
+    traced = is_tracing();
+    if (ScopedPhase::profiler != NULL || traced) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+// Stops timing the phase.
+inline ScopedPhase::~ScopedPhase() {
+    if (profiler == NULL && !traced) {
+        return;
+    }
+    std::chrono::steady_clock::duration time = std::chrono::steady_clock::now() - start;
+    if (profiler != NULL) {
+        profiler->add_time(phase, time);
+    }
+    if (traced) {
+        trace_span(FrameProfiler::get_phase_name(phase), "frame", start, time);
+    }
+}
+
+#endif
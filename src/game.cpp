@@ -3,6 +3,8 @@
 #include "game_stat.h"
 #include "leaderboard.h"
 #include "level.h"
+#include "level_pack.h"
+#include "math_utils.h"
 #include "ncu.h"
 #include "paddle.h"
 #include "playing_field.h"
@@ -10,13 +12,16 @@
 #include "power_up_drop.h"
 #include "power_up_list.h"
 #include "rect.h"
-#include "rect_block.h"
 #include "rect_wall.h"
+#include "trace.h"
 #include "well.h"
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 // Readies the screen for drawing characters in the terminal.
@@ -29,20 +34,89 @@ void Game::initialize_screen() {
     // timeout(-1);
 
     pf.set_display_window();
+    if (ansi_output) {
+        delete ansi_target;
+        ansi_target = new AnsiTarget(pf.get_display_window(), stdout);
+        pf.set_render_target(*ansi_target);
+    }
+    terminal_link.bind_input_reader(input);
     game_stat.set_display_window(pf.max_x, pf.max_y);
+    game_stat.bind_profiler(profiler);
     bar.set_display_window(pf.max_y + 6);
     nodelay(pf.get_display_window(), true);
     keypad(pf.get_display_window(), true);
+    // The InputReader reads stdin while the game is drawn, so ncurses must not read it to check for typeahead
+    typeahead(-1);
 }
 
-// Loads a level from a file and initializes it.
-// level_file: The address of the level file to load.
+// Frees the ANSI output, if any.
+Game::~Game() {
+    delete ansi_target;
+}
+
+// Sets the seed of the session. Games played with the same seed and the same keys play out the same way.
+// seed: The seed.
+void Game::set_seed(unsigned int seed) {
+    session_seed = seed;
+}
+
+// Records the keys of every game played from then on.
+// recorder: The InputRecorder to record to. It must outlive the game.
+void Game::set_recorder(InputRecorder &recorder) {
+    Game::recorder = &recorder;
+}
+
+// Sets the level pack to load levels from. Levels not in the pack are still loaded from their files.
+// level_pack: The opened level pack. It must outlive the game.
+void Game::set_level_pack(LevelPack &level_pack) {
+    Game::level_pack = &level_pack;
+}
+
+// Writes the phase times of every frame played from then on to a CSV file (see FrameProfiler).
+// Throws a runtime error if the file cannot be opened.
+// filename: The address of the file. It is overwritten.
+void Game::set_profile_file(std::string filename) {
+    profiler.open_csv(filename);
+}
+
+// Sends the playing field to the terminal with an AnsiTarget from the next game on, instead of through ncurses.
+// enabled: Whether to use the ANSI output.
+void Game::set_ansi_output(bool enabled) {
+    ansi_output = enabled;
+}
+
+// Sets whether the playing field is always drawn with reduced detail, instead of only when the terminal
+// cannot keep up.
+// enabled: Whether the detail is always reduced.
+void Game::set_low_detail(bool enabled) {
+    low_detail = enabled;
+}
+
+// Loads a level from the level pack, or from its file if it is not in the pack, and initializes it.
+// The function throws a runtime error if the level cannot be loaded from either.
+// level_file: The address of the level file to load, which is also its name in the pack.
 void Game::initialize_level(std::string level_file) {
     cur_lv = new Level();
     cur_lv->bind_stat(game_stat);
     cur_lv->bind_playing_field(pf);
     cur_lv->bind_notification_bar(bar);
-    cur_lv->load_level_by_file(level_file);
+    cur_lv->bind_frame_clock(frame_clock);
+    cur_lv->bind_input_reader(input);
+    cur_lv->bind_profiler(profiler);
+    cur_lv->set_seed(derive_seed(game_seed, levels_played++));
+    if (recorder != NULL) {
+        recorder->begin_level(level_file);
+        cur_lv->bind_recorder(*recorder);
+    }
+    TraceSpan span("load level", "io", level_file.c_str());
+    const char *image;
+    size_t image_size;
+    if (level_pack == NULL || !level_pack->read(level_file, image, image_size) ||
+        cur_lv->load_level_by_image(image, image_size) != 0) {
+        if (cur_lv->load_level_by_file(level_file) != 0) {
+            throw std::runtime_error("Failed to load " + level_file + ". Please check if it is missing.");
+        }
+    }
     cur_lv->render_screen();
     cur_lv->set_quit_status(false);
 }
@@ -65,18 +139,29 @@ bool Game::game_ended() {
 
 // Runs a round, starting from launching the ball to losing all balls on the field.
 void Game::run_round() {
+    TraceSpan span("round", "game");
+    trace_instant("round start", "game", "lives", game_stat.get_lives());
     bar.display("Press SPACE to launch the ball.");
     bar.tick();
 
+    frame_clock.start();
     cur_lv->launch_ball();
     bar.reset();
     do {
-        cur_lv->run_loop();
         // Wait for a frame
-        napms(33);
+        int ticks;
+        {
+            ScopedPhase phase(&profiler, FrameProfiler::WAIT);
+            ticks = frame_clock.wait_for_frame();
+        }
+        TraceSpan frame("frame", "frame");
+        cur_lv->run_loop(ticks);
+        profiler.end_frame(ticks);
+        update_detail();
     } while (!round_ended());
 
     if (!cur_lv->has_ball()) {
+        trace_instant("ball lost", "game");
         game_stat.sub_lives();
     }
 
@@ -88,9 +173,21 @@ void Game::run_round() {
     }
 }
 
+// Checks how the terminal is keeping up after a frame, and reduces or restores the detail of the playing field.
+void Game::update_detail() {
+    link_monitor.end_frame();
+    bool reduced = low_detail || link_monitor.is_reduced();
+    if (reduced == pf.is_reduced_detail()) {
+        return;
+    }
+    pf.set_reduced_detail(reduced);
+    bar.display(reduced ? "Slow terminal: reduced detail." : "Full detail restored.");
+}
+
 // Runs a level, starting with all the bricks and ending when there are no bricks left.
 // level_file: The address of the level file to load.
 void Game::run_level(std::string level_file) {
+    TraceSpan span("level", "game", level_file.c_str());
     initialize_level(level_file);
     game_stat.add_level();
 
@@ -99,8 +196,12 @@ void Game::run_level(std::string level_file) {
     } while (!level_ended());
 
     cur_lv->render_screen();
+    if (recorder != NULL) {
+        recorder->end_level(game_stat.get_score());
+    }
     cur_lv->destroy_objects();
     delete cur_lv;
+    cur_lv = NULL;
 
     game_stat.reset_lv_stats();
     game_stat.reset_timer();
@@ -111,16 +212,42 @@ void Game::run_level(std::string level_file) {
 // filenames: The addresses of the level files to load sequentially.
 void Game::run_game(std::vector<std::string> filenames) {
     initialize_screen();
+    input.reset_stats();
+    input.start();
+    link_monitor.reset();
+    pf.set_reduced_detail(low_detail);
+
+    game_seed = derive_seed(session_seed, games_played++);
+    levels_played = 0;
+    if (recorder != NULL) {
+        recorder->begin_game(game_seed);
+    }
 
     bool all_completed = true;
-    for (auto filename : filenames) {
-        run_level(filename);
-        if (game_ended()) {
-            all_completed = false;
-            break;
+    try {
+        for (auto filename : filenames) {
+            run_level(filename);
+            if (game_ended()) {
+                all_completed = false;
+                break;
+            }
+        }
+    } catch (std::runtime_error &e) {
+        // A level with a mistake ends the program (see main), which needs the reader thread stopped and the
+        // terminal handed back to ncurses first. The level it was in is freed, as run_level() did not get to
+        if (cur_lv != NULL) {
+            cur_lv->destroy_objects();
+            delete cur_lv;
+            cur_lv = NULL;
         }
+        input.stop();
+        pf.get_render_target().release();
+        throw;
     }
 
+    // Keys are read through ncurses again from here on
+    input.stop();
+
     // Print game over screen
     print_stats(all_completed);
     while (true) {
@@ -135,28 +262,51 @@ void Game::run_game(std::vector<std::string> filenames) {
     // Reset stats
     game_stat.reset_all_stats();
     game_stat.reset_timer();
+    frame_clock.reset_missed_deadlines();
 }
 
 // Prints the game over screen.
 // all_completed: Whether the player cleared every level. If so, a congratulatory message will be shown.
 void Game::print_stats(bool all_completed) {
+    pf.get_render_target().release();
     game_stat.clear_window();
     WINDOW *pf_win = pf.get_display_window();
 
     werase(pf_win);
 
+    InputStats input_stats = input.get_stats();
+    std::stringstream latency;
+    latency << "Input latency: mean " << std::fixed << std::setprecision(1) << input_stats.mean_latency_us / 1000
+            << " ms, max " << input_stats.max_latency_us / 1000 << " ms";
+
     std::vector<std::string> strings = {
         all_completed ? "Game Complete!" : "Game Over",
         "",
         "Highest Level: " + std::to_string(game_stat.get_level()),
         "Score: " + std::to_string(game_stat.get_score()),
+        "Late frames: " + std::to_string(frame_clock.get_missed_deadlines()),
+        latency.str(),
         "",
         "Press ENTER to continue"};
 
-    int y_begin = strings.size() / 2;
+    if (ansi_target != NULL && ansi_target->get_frame_count() > 0) {
+        std::stringstream output;
+        output << "Output: " << std::fixed << std::setprecision(0)
+               << (double)ansi_target->get_total_bytes() / ansi_target->get_frame_count() << " bytes per frame";
+        strings.insert(strings.end() - 2, output.str());
+    }
+    if (link_monitor.get_reduced_frame_count() > 0 && !low_detail) {
+        std::stringstream detail;
+        detail << "Reduced detail: " << std::fixed << std::setprecision(0)
+               << 100.0 * link_monitor.get_reduced_frame_count() / link_monitor.get_frame_count() << "% of frames";
+        strings.insert(strings.end() - 2, detail.str());
+    }
+
+    // Centered, with a blank row between lines, so that every line fits in the window
+    int y_begin = (pf.max_y - (int)strings.size() * 2 + 1) / 2;
     for (int i = 0; i < strings.size(); i++) {
         std::string str = strings.at(i);
-        wmove(pf_win, y_begin + pf.max_y / 2 + i * 2, pf.max_x / 2 - str.length() / 2);
+        wmove(pf_win, y_begin + i * 2, pf.max_x / 2 - str.length() / 2);
         wprintw(pf_win, str.c_str());
     }
     wrefresh(pf_win);
@@ -1,7 +1,14 @@
+#include "ansi_target.h"
 #include "ball.h"
 #include "game_stat.h"
+#include "input_reader.h"
+#include "input_recorder.h"
 #include "leaderboard.h"
+#include "frame_clock.h"
+#include "frame_profiler.h"
 #include "level.h"
+#include "level_pack.h"
+#include "link_monitor.h"
 #include "notification_bar.h"
 #include "paddle.h"
 #include "playing_field.h"
@@ -18,19 +25,48 @@ class Game {
     private:
         PlayingField pf = PlayingField({32.0, 32.0});
         WINDOW *info_screen;
-        Level *cur_lv;
+        Level *cur_lv = NULL;
         NotificationBar bar = NotificationBar(64, 1);
         GameStat game_stat;
+        FrameClock frame_clock;
+        // Reads the keys on its own thread while the levels are played.
+        InputReader input;
+        // Times the phases of every frame, for the overlay and the CSV file.
+        FrameProfiler profiler;
+        // Whether the playing field is sent to the terminal by an AnsiTarget instead of ncurses.
+        bool ansi_output = false;
+        AnsiTarget *ansi_target = NULL;
+        // Reduces the detail when the terminal cannot keep up, unless the detail is always reduced.
+        TerminalLink terminal_link = TerminalLink(stdout);
+        LinkMonitor link_monitor = LinkMonitor(terminal_link);
+        bool low_detail = false;
         Leaderboard lb;
         Record rc;
 
+        // Each game draws its random numbers from a seed derived from the session seed,
+        // and each level from a seed derived from the game seed.
+        unsigned int session_seed = 0, game_seed = 0;
+        int games_played = 0, levels_played = 0;
+        InputRecorder *recorder = NULL;
+        // Levels are loaded from this pack when it has them, and from their files otherwise.
+        LevelPack *level_pack = NULL;
+
         void initialize_screen();
+        void update_detail();
 
         void print_stats(bool all_completed);
         void add_record_to_leaderboard();
         std::string get_player_name(int rank);
 
     public:
+        ~Game();
+
+        void set_seed(unsigned int seed);
+        void set_recorder(InputRecorder &recorder);
+        void set_level_pack(LevelPack &level_pack);
+        void set_profile_file(std::string filename);
+        void set_ansi_output(bool enabled);
+        void set_low_detail(bool enabled);
         void run_game(std::vector<std::string> filenames);
         void initialize_level(std::string level_file);
         void run_level(std::string level_file);
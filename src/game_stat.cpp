@@ -1,7 +1,7 @@
 #include "game_stat.h"
 #include "game_stat_timer.h"
-#include "general_utils.h"
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <vector>
@@ -202,14 +202,9 @@ void GameStat::reset_all_stats() {
     level = 0;
 }
 
-// Returns the string used to display the number of lives.
-// The string shows the current number of lives, and the number of bonus lives gained.
-std::string GameStat::live_display() {
-    return std::to_string(get_lives()) + " (" + std::to_string(get_extra_lives()) + " bonus)";
-}
-
 // Prints out the game stats to the side of the screen,
 // including the score, multiplier, and power-up timers.
+// The window is staged with wnoutrefresh(), and shown with the next frame of the playing field.
 void GameStat::draw_display_window() {
     wattron(display_window, A_NORMAL);
     werase(display_window);
@@ -217,6 +212,11 @@ void GameStat::draw_display_window() {
     int max_y, max_x;
     getmaxyx(display_window, max_y, max_x);
 
+    if (profiler_ptr != NULL && profiler_ptr->overlay_shown()) {
+        draw_profiler_overlay();
+        return;
+    }
+
     wmove(display_window, 0, 2);
     wprintw(display_window, "[LEVEL %i]", get_level());
 
@@ -224,7 +224,7 @@ void GameStat::draw_display_window() {
     wprintw(display_window, "BALLS");
 
     wmove(display_window, 2, 1);
-    wprintw(display_window, "%s", live_display().c_str());
+    wprintw(display_window, "%i (%i bonus)", get_lives(), get_extra_lives());
 
     wmove(display_window, 1, max_x / 2 - 2);
     wprintw(display_window, "SCORE");
@@ -234,7 +234,7 @@ void GameStat::draw_display_window() {
 
     wmove(display_window, 3, max_x / 2 - 1);
 
-    if (get_timer().score % (300 / (get_timer().score + 1)) == 1 || get_timer().score > 100) {
+    if (multiplier_shown()) {
         wprintw(display_window, "x%i", get_score_multi());
     }
 
@@ -250,15 +250,76 @@ void GameStat::draw_display_window() {
         wmove(display_window, 4, max_x / 2 - 17);
         wprintw(display_window, "SPEED [                    ]");
         wmove(display_window, 4, max_x / 2 - 10);
-        wprintw(display_window, "%s", strmulti(".", get_timer().speed / 10).c_str());
+        if (get_timer().speed >= 10) {
+            whline(display_window, '.', get_timer().speed / 10);
+        }
     }
-    wrefresh(display_window);
+    // Sent to the terminal with the playing field at the end of the frame
+    wnoutrefresh(display_window);
+
+    read_shown_values(shown_values);
+    has_shown_values = true;
+}
+
+// Draws the mean and max time of each phase of a frame over the last frames, in microseconds.
+// Called by draw_display_window() while the overlay is shown.
+void GameStat::draw_profiler_overlay() {
+    wmove(display_window, 0, 2);
+    wprintw(display_window, "[FRAME TIMES: MEAN/MAX US, F TO HIDE]");
+
+    const int per_row = 3, column_width = 20;
+    for (int i = 0; i < FrameProfiler::PHASE_COUNT; i++) {
+        FrameProfiler::Phase phase = (FrameProfiler::Phase)i;
+        wmove(display_window, 1 + i / per_row, 1 + (i % per_row) * column_width);
+        wprintw(display_window, "%-8s%5.0f/%-5.0f", FrameProfiler::get_phase_name(phase),
+                profiler_ptr->get_mean_us(phase), profiler_ptr->get_max_us(phase));
+    }
+    wnoutrefresh(display_window);
+
+    read_shown_values(shown_values);
+    has_shown_values = true;
+}
+
+// Draws the game statistics window again only if any value shown on it has changed since it was last drawn.
+void GameStat::update_display_window() {
+    int values[shown_value_count];
+    read_shown_values(values);
+    if (has_shown_values && std::equal(values, values + shown_value_count, shown_values)) {
+        return;
+    }
+    draw_display_window();
+}
+
+// Returns if the score multiplier is shown. It blinks faster as the multiplier is about to run out.
+bool GameStat::multiplier_shown() {
+    return get_timer().score % (300 / (get_timer().score + 1)) == 1 || get_timer().score > 100;
+}
+
+// Reads every value that draw_display_window() shows.
+// values: An array of shown_value_count integers to write the values to.
+void GameStat::read_shown_values(int values[]) {
+    values[0] = get_level();
+    values[1] = get_lives();
+    values[2] = get_extra_lives();
+    values[3] = get_score();
+    values[4] = multiplier_shown() ? get_score_multi() : 0;
+    values[5] = get_missile();
+    values[6] = get_timer().speed > 0;
+    values[7] = get_timer().speed / 10;
+    values[8] = (profiler_ptr != NULL && profiler_ptr->overlay_shown()) ? profiler_ptr->get_report_count() + 1 : 0;
 }
 
 // Hides the game statistics window.
 void GameStat::clear_window() {
     werase(display_window);
     wrefresh(display_window);
+    has_shown_values = false;
+}
+
+// Connects a FrameProfiler, whose overlay is drawn in place of the stats while it is shown.
+// profiler: The FrameProfiler to connect to.
+void GameStat::bind_profiler(FrameProfiler &profiler) {
+    profiler_ptr = &profiler;
 }
 
 // Creates a new display window for showing game stats.
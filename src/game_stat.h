@@ -1,6 +1,7 @@
 #ifndef GAME_STAT_H_
 #define GAME_STAT_H_
 
+#include "frame_profiler.h"
 #include "game_stat_timer.h"
 #include "ncu.h"
 
@@ -44,9 +45,12 @@ class GameStat {
 
         void clear_window();
 
+        void bind_profiler(FrameProfiler &profiler);
+
         void set_display_window(double max_x, double max_y);
         WINDOW *get_display_window();
         void draw_display_window();
+        void update_display_window();
 
     private:
         GameStatTimer timer;
@@ -54,7 +58,17 @@ class GameStat {
         double time_left;
         void apply_ball_speed_timer();
 
-        std::string live_display();
+        bool multiplier_shown();
+
+        // The values on the display window when it was last drawn, in the order set by read_shown_values().
+        static const int shown_value_count = 9;
+        int shown_values[shown_value_count];
+        bool has_shown_values = false;
+        void read_shown_values(int values[]);
+
+        // Its overlay is drawn in place of the stats while it is shown.
+        FrameProfiler *profiler_ptr = NULL;
+        void draw_profiler_overlay();
 
         WINDOW *display_window;
 };
@@ -0,0 +1,307 @@
+#include "input_reader.h"
+#include "ncu.h"
+#include "trace.h"
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+const int InputReader::hold_ms;
+const int InputReader::repeat_ms;
+
+// Constructs a reader that is not reading yet.
+// fd: The file descriptor to read keys from. The game reads stdin; a check can feed keys through a pipe.
+InputReader::InputReader(int fd) {
+    InputReader::fd = fd;
+    // At most a full queue is taken at once, so taking keys never allocates
+    pending.reserve(queue_capacity);
+    // Bytes are read 64 at a time, and only an unfinished escape sequence is kept between reads
+    bytes.reserve(256);
+    held_key = ERR;
+    last_key = ERR;
+}
+
+// Stops the reader thread, if it is running.
+InputReader::~InputReader() {
+    stop();
+}
+
+// Starts reading keys on a new thread. Does nothing if the reader is already running.
+void InputReader::start() {
+    if (running) {
+        return;
+    }
+    suspend_requested = false;
+    parked = false;
+    running = true;
+    thread = std::thread(&InputReader::run, this);
+}
+
+// Stops reading keys and waits for the reader thread to finish. Keys not taken yet are thrown away.
+void InputReader::stop() {
+    if (!running) {
+        return;
+    }
+    wait_for_position_reports();
+    running = false;
+    thread.join();
+
+    KeyEvent event;
+    while (queue.pop(event)) {
+        continue;
+    }
+    pending.clear();
+    held_key = ERR;
+    last_key = ERR;
+}
+
+// Stops reading keys until resume() is called, so that ncurses can read them instead.
+// Waits until the reader thread has stopped reading. Keys not taken yet are thrown away.
+void InputReader::suspend() {
+    if (!running) {
+        return;
+    }
+    wait_for_position_reports();
+    ++suspensions;
+    suspend_requested = true;
+    while (!parked) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    KeyEvent event;
+    while (queue.pop(event)) {
+        continue;
+    }
+    pending.clear();
+    held_key = ERR;
+    last_key = ERR;
+}
+
+// Waits for a while for the cursor position reports still on their way, which ncurses would otherwise read
+// as keys once the reader stops. Any that have not arrived by then are given up on.
+void InputReader::wait_for_position_reports() {
+    std::chrono::steady_clock::time_point give_up = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (reports_read < reports_expected && std::chrono::steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    reports_expected = reports_read.load();
+}
+
+// Starts reading keys again after suspend().
+void InputReader::resume() {
+    suspend_requested = false;
+}
+
+// The reader thread. Reads bytes from the file descriptor as they arrive and turns them into keys.
+void InputReader::run() {
+    name_trace_thread("input");
+    while (running) {
+        if (suspend_requested) {
+            parked = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+        parked = false;
+
+        if (!wait_for_bytes(10) || suspend_requested) {
+            continue;
+        }
+        unsigned char buffer[64];
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count <= 0) {
+            continue;
+        }
+        bytes.insert(bytes.end(), buffer, buffer + count);
+
+        decode_bytes(false);
+        // An escape on its own is the Esc key, unless the rest of an arrow key follows right after
+        if (!bytes.empty() && !wait_for_bytes(25)) {
+            decode_bytes(true);
+        }
+    }
+    parked = true;
+}
+
+// Waits until the file descriptor has bytes to read. Returns false if none arrive in time.
+// timeout_ms: The longest time to wait, in milliseconds.
+bool InputReader::wait_for_bytes(int timeout_ms) {
+    struct pollfd input_poll = {fd, POLLIN, 0};
+    return poll(&input_poll, 1, timeout_ms) > 0 && (input_poll.revents & POLLIN);
+}
+
+// Turns the bytes read so far into keys. An arrow key arrives as "ESC [ A" or "ESC O A" (up; B, C and D
+// are down, right and left), possibly with numbers before the letter, e.g. "ESC [ 1 ; 2 A".
+// "ESC [ row ; col R" is the terminal's reply to a cursor position request, and is counted as a report.
+// Other escape sequences are dropped, and any other byte is a key of its own.
+// flush: If true, an unfinished escape sequence is given up on, and its bytes become keys of their own.
+//        Otherwise, it is kept until more bytes arrive.
+void InputReader::decode_bytes(bool flush) {
+    size_t i = 0;
+    while (i < bytes.size()) {
+        if (bytes[i] != 27) {
+            push_key(bytes[i] == '\r' ? '\n' : bytes[i]);
+            ++i;
+            continue;
+        }
+
+        // Find the end of the escape sequence
+        size_t end = i + 1;
+        bool complete = false;
+        if (end < bytes.size() && (bytes[end] == '[' || bytes[end] == 'O')) {
+            ++end;
+            while (end < bytes.size() && ((bytes[end] >= '0' && bytes[end] <= '9') || bytes[end] == ';')) {
+                ++end;
+            }
+            complete = end < bytes.size();
+        }
+        if (!complete) {
+            if (i + 1 < bytes.size() && bytes[i + 1] != '[' && bytes[i + 1] != 'O') {
+                // Escape followed by an ordinary key
+                push_key(27);
+                ++i;
+                continue;
+            }
+            if (!flush) {
+                break;
+            }
+            for (; i < bytes.size(); i++) {
+                push_key(bytes[i]);
+            }
+            break;
+        }
+
+        switch (bytes[end]) {
+        case 'A':
+            push_key(KEY_UP);
+            break;
+        case 'B':
+            push_key(KEY_DOWN);
+            break;
+        case 'C':
+            push_key(KEY_RIGHT);
+            break;
+        case 'D':
+            push_key(KEY_LEFT);
+            break;
+        case 'R':
+            last_report_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now().time_since_epoch()).count();
+            ++reports_read;
+            break;
+        }
+        i = end + 1;
+    }
+    bytes.erase(bytes.begin(), bytes.begin() + i);
+}
+
+// Timestamps a key and passes it to the game. The key is dropped if the game has fallen too far behind.
+// key: The key.
+void InputReader::push_key(int key) {
+    KeyEvent event = {key, std::chrono::steady_clock::now()};
+    trace_instant("key", "input", "key", key);
+    if (!queue.push(event)) {
+        ++overflowed;
+    }
+}
+
+// Returns if a key moves the paddle.
+// key: The key.
+bool is_movement_key(int key) {
+    return key == KEY_LEFT || key == KEY_RIGHT || key == KEY_UP || key == KEY_DOWN;
+}
+
+// Takes the keys that arrived since the last frame and gives each tick of this frame at most one key.
+// If more movement keys arrived than there are ticks, repeats of the same key are folded into one,
+// so the paddle does not keep moving on stale key presses in later frames. Other keys wait for the next frame
+// if this one has no tick left for them, but at most queue_capacity keys wait at once: when more arrive,
+// the oldest are dropped (and counted as overflowed), so a key never waits more than a few frames.
+// A tick with no key keeps moving the paddle if a movement key is being held down, i.e. the terminal
+// repeated it, and the last repeat arrived in the last hold_ms.
+// ticks: The number of ticks in this frame.
+// keys: Set to the key for each tick, or ERR.
+void InputReader::read_frame(int ticks, std::vector<int> &keys) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    KeyEvent event;
+    while (queue.pop(event)) {
+        if (pending.size() >= queue_capacity) {
+            pending.erase(pending.begin());
+            ++stats.overflowed;
+        }
+        pending.push_back(event);
+    }
+
+    keys.assign(ticks, ERR);
+    size_t next = 0;
+    for (int tick = 0; tick < ticks; tick++) {
+        if (next < pending.size()) {
+            // Fold repeats while there are more keys waiting than ticks left
+            while (is_movement_key(pending[next].key) && next + 1 < pending.size() &&
+                   pending[next + 1].key == pending[next].key && pending.size() - next > (size_t)(ticks - tick)) {
+                ++next;
+                ++stats.folded;
+            }
+
+            KeyEvent &used = pending[next++];
+            keys[tick] = used.key;
+            double latency_us = std::chrono::duration<double, std::micro>(now - used.time).count();
+            total_latency_us += latency_us;
+            stats.max_latency_us = std::max(stats.max_latency_us, latency_us);
+            ++stats.used;
+
+            // A single press moves the paddle once; only a key the terminal is repeating is held
+            if (used.key == last_key && used.time - last_time < std::chrono::milliseconds(repeat_ms)) {
+                held_key = used.key;
+                held_until = used.time + std::chrono::milliseconds(hold_ms);
+            } else {
+                held_key = ERR;
+            }
+            last_key = is_movement_key(used.key) ? used.key : ERR;
+            last_time = used.time;
+        } else if (held_key != ERR && now < held_until) {
+            keys[tick] = held_key;
+        }
+    }
+    pending.erase(pending.begin(), pending.begin() + next);
+}
+
+// Notes that a cursor position request was just sent to the terminal, so that its reply is waited for
+// before the reader is suspended or stopped.
+void InputReader::expect_position_report() {
+    ++reports_expected;
+}
+
+// Returns the number of cursor position reports read so far.
+long long InputReader::get_position_reports() {
+    return reports_read;
+}
+
+// Returns the number of times the reader has been suspended. Reports on their way when it is suspended are
+// given up on, and may never be read.
+long long InputReader::get_suspensions() {
+    return suspensions;
+}
+
+// Returns when the last cursor position report was read.
+std::chrono::steady_clock::time_point InputReader::get_last_report_time() {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(last_report_ns.load())));
+}
+
+// Returns how quickly keys reached the game since the stats were last reset.
+InputStats InputReader::get_stats() {
+    InputStats result = stats;
+    result.overflowed = stats.overflowed + overflowed;
+    result.mean_latency_us = stats.used > 0 ? total_latency_us / stats.used : 0;
+    return result;
+}
+
+// Starts counting the stats from zero.
+void InputReader::reset_stats() {
+    stats = InputStats();
+    total_latency_us = 0;
+    overflowed = 0;
+}
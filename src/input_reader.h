@@ -0,0 +1,96 @@
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifndef INPUT_READER_H_
+#define INPUT_READER_H_
+
+// A key pressed by the player, and when it was read from the terminal.
+struct KeyEvent {
+    int key;
+    std::chrono::steady_clock::time_point time;
+};
+
+// How quickly keys reached the game, for the game over screen.
+struct InputStats {
+    // Keys used by the game, and keys folded into another key press of the same direction.
+    long long used = 0, folded = 0;
+    // Keys lost because the queue was full, or because too many were waiting for a tick.
+    long long overflowed = 0;
+    // Time from a key being read to the frame that used it, in microseconds.
+    double mean_latency_us = 0, max_latency_us = 0;
+};
+
+// Reads keys from the terminal on its own thread while a level is played, so that no key waits for a frame
+// to be read. Each key is timestamped and passed to the game through a lock-free queue, and the game takes
+// the keys for a whole frame at once with read_frame().
+//
+// The reader reads stdin directly and decodes arrow keys itself, so it must be suspended while anything else
+// reads keys through ncurses (e.g. the pause menu). It also takes the terminal's replies to cursor position
+// requests out of the keys, so that the time a reply takes to come back can be measured (see LinkMonitor).
+class InputReader {
+    public:
+        InputReader(int fd = 0);
+        ~InputReader();
+
+        void start();
+        void stop();
+        void suspend();
+        void resume();
+
+        void read_frame(int ticks, std::vector<int> &keys);
+
+        void expect_position_report();
+        long long get_position_reports();
+        long long get_suspensions();
+        std::chrono::steady_clock::time_point get_last_report_time();
+
+        InputStats get_stats();
+        void reset_stats();
+
+    private:
+        // How long a repeated movement key keeps moving the paddle, so that a held key, which the terminal
+        // repeats only every 30 ms or so, moves the paddle every frame instead of every other frame.
+        static const int hold_ms = 45;
+        // The longest gap between two presses of a key for the second one to count as the key being held.
+        static const int repeat_ms = 100;
+
+        // The file descriptor the keys are read from, stdin in the game.
+        int fd;
+        std::thread thread;
+        std::atomic<bool> running{false}, suspend_requested{false}, parked{false};
+        std::atomic<long long> overflowed{0};
+        // Cursor position reports ("ESC [ row ; col R") asked for with expect_position_report(), and the ones
+        // read so far. A report is not a key, and the time the last one was read is kept instead.
+        std::atomic<long long> reports_expected{0}, reports_read{0};
+        std::atomic<long long> last_report_ns{0};
+        // The most keys that can wait for the game at once.
+        static const size_t queue_capacity = 256;
+        SpscQueue<KeyEvent, queue_capacity> queue;
+
+        // Only used by the reader thread.
+        std::vector<unsigned char> bytes;
+
+        // Only used by the game thread.
+        std::vector<KeyEvent> pending;
+        long long suspensions = 0;
+        int held_key, last_key;
+        std::chrono::steady_clock::time_point held_until, last_time;
+        InputStats stats;
+        double total_latency_us = 0;
+
+        void run();
+        void wait_for_position_reports();
+        bool wait_for_bytes(int timeout_ms);
+        void decode_bytes(bool flush);
+        void push_key(int key);
+
+        // A reader owns its thread, so it cannot be copied.
+        InputReader(const InputReader &);
+        InputReader &operator=(const InputReader &);
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "input_recorder.h"
+#include "sim_input.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The number of tokens written on each line of a recording.
+const int tokens_per_line = 20;
+
+// Opens a file to record to. Throws a runtime error if the file cannot be opened.
+// filename: The address of the file. It is overwritten.
+InputRecorder::InputRecorder(std::string filename) {
+    fout.open(filename);
+    if (fout.fail()) {
+        throw std::runtime_error("Failed to open " + filename + " for recording.");
+    }
+}
+
+// Starts recording a new game.
+// seed: The seed that the game draws its random numbers from.
+void InputRecorder::begin_game(unsigned int seed) {
+    fout << "seed " << seed << "\n";
+}
+
+// Starts recording a new level.
+// level_file: The address of the level file being played.
+void InputRecorder::begin_level(std::string level_file) {
+    fout << "level " << level_file << "\n";
+    frames = 0;
+    tokens_on_line = 0;
+}
+
+// Records the key pressed in one frame. Repeated keys are written once with a repeat count.
+// ch: The key pressed, or ERR if nothing was pressed.
+void InputRecorder::record(int ch) {
+    std::string token = key_to_script_token(ch);
+    if (pending_count > 0 && token != pending_token) {
+        write_pending();
+    }
+    pending_token = token;
+    ++pending_count;
+    ++frames;
+}
+
+// Finishes recording a level, noting how it ended so that a replay can be checked against it.
+// score: The total score when the level ended.
+void InputRecorder::end_level(int score) {
+    write_pending();
+    if (tokens_on_line > 0) {
+        fout << "\n";
+    }
+    fout << "end " << frames << " " << score << "\n";
+    fout.flush();
+}
+
+// Writes the last recorded token, with its repeat count if it was recorded more than once.
+void InputRecorder::write_pending() {
+    if (pending_count == 0) {
+        return;
+    }
+    if (tokens_on_line > 0) {
+        fout << " ";
+    }
+    if (pending_count > 1) {
+        fout << pending_count << "*";
+    }
+    fout << pending_token;
+    pending_count = 0;
+
+    if (++tokens_on_line >= tokens_per_line) {
+        fout << "\n";
+        tokens_on_line = 0;
+    }
+}
+
+// Reads a recording written by an InputRecorder. Throws a runtime error if the file cannot be read.
+// filename: The address of the recording.
+std::vector<RecordedGame> read_recording(std::string filename) {
+    std::ifstream fin(filename);
+    if (fin.fail()) {
+        throw std::runtime_error("Failed to open " + filename);
+    }
+
+    std::vector<RecordedGame> games;
+    std::string line;
+    while (std::getline(fin, line)) {
+        std::istringstream ss(line);
+        std::string word;
+        if (!(ss >> word)) {
+            continue;
+        }
+
+        if (word == "seed") {
+            games.push_back(RecordedGame());
+            ss >> games.back().seed;
+        } else if (games.empty()) {
+            throw std::runtime_error(filename + " does not start with a seed.");
+        } else if (word == "level") {
+            games.back().levels.push_back(RecordedLevel());
+            ss >> games.back().levels.back().level_file;
+        } else if (games.back().levels.empty()) {
+            throw std::runtime_error(filename + ": keys recorded before any level.");
+        } else if (word == "end") {
+            RecordedLevel &level = games.back().levels.back();
+            ss >> level.frames >> level.score;
+        } else {
+            games.back().levels.back().script += line + "\n";
+        }
+    }
+    return games;
+}
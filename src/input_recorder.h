@@ -0,0 +1,49 @@
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef INPUT_RECORDER_H_
+#define INPUT_RECORDER_H_
+
+// Writes the key of every simulated frame to a file, so that a game can be replayed with the simulator.
+// A recording is plain text. Each game starts with "seed <n>", then each level has a line "level <file>",
+// the keys in the same tokens as an input script (see ScriptedInput), and a line "end <frames> <score>".
+class InputRecorder {
+    public:
+        InputRecorder(std::string filename);
+
+        void begin_game(unsigned int seed);
+        void begin_level(std::string level_file);
+        void record(int ch);
+        void end_level(int score);
+
+    private:
+        std::ofstream fout;
+
+        // The last token and how many frames in a row it was recorded, not yet written.
+        std::string pending_token;
+        int pending_count = 0;
+        int tokens_on_line = 0;
+        int frames = 0;
+
+        void write_pending();
+};
+
+// One level of a recording.
+struct RecordedLevel {
+    std::string level_file;
+    std::string script;
+    // What the level ended with when it was recorded, or -1 if the recording stops before the level ended.
+    int frames = -1;
+    int score = -1;
+};
+
+// One game of a recording: the seed it was played with and the levels played.
+struct RecordedGame {
+    unsigned int seed = 0;
+    std::vector<RecordedLevel> levels;
+};
+
+std::vector<RecordedGame> read_recording(std::string filename);
+
+#endif
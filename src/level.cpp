@@ -3,20 +3,19 @@
 #include "game_stat.h"
 #include "loot_table.h"
 #include "math_utils.h"
-#include "menu.h"
 #include "missile.h"
 #include "ncu.h"
 #include "notification_bar.h"
 #include "power_up_drop.h"
 #include "power_up_list.h"
 #include "rect_wall.h"
+#include "trace.h"
 
-#include <iomanip>
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <map>
 #include <random>
-#include <sstream>
-#include <time.h>
 
 // Creates a new level, which is a set of bricks to break. Clear all the bricks to complete a level.
 // subject_rect: The size of a brick, defined by two of its opposite corners.
@@ -26,13 +25,15 @@
 // y_repeat: The number of columns of bricks.
 Level::Level(Rect subject_rect, double x_separation, double y_separation, int x_repeat, int y_repeat) {
 
-    RectBlock::create_rectblocks(bricks, subject_rect, x_separation, y_separation, x_repeat, y_repeat);
+    bricks.add_grid(subject_rect, x_separation, y_separation, x_repeat, y_repeat);
+    brick_grid.build(bricks);
+    init_brick_lists();
 
     construct_loot_table();
 
-    init_ball();
+    init_entity_lists();
 
-    srand(time(0));
+    init_ball();
 }
 
 // Initializes the list of power-ups.
@@ -45,6 +46,14 @@ void Level::construct_loot_table() {
     pity_map[PowerUpList::MISSILE] = 1;
 
     pity_table = new LootTable(pity_map);
+
+    seed_loot_tables();
+}
+
+// Starts the random streams of both loot tables from the level seed.
+void Level::seed_loot_tables() {
+    loot_table->seed(derive_seed(seed, 0));
+    pity_table->seed(derive_seed(seed, 1));
 }
 
 // Removes both loot tables from memory.
@@ -56,13 +65,11 @@ void Level::destruct_loot_table() {
 // Creates a new level, but with no bricks created at first.
 Level::Level() {
 
-    std::set<RectBlock *> bricks = {};
-
     construct_loot_table();
 
-    init_ball();
+    init_entity_lists();
 
-    srand(time(0));
+    init_ball();
 }
 
 // Connects the level to a GameStat, making the GameStat reusable across levels.
@@ -75,51 +82,78 @@ void Level::bind_stat(GameStat &game_stat) {
 // pf: the PLayingField to connect to.
 void Level::bind_playing_field(PlayingField &pf) {
     pf_ptr = &pf;
+    static_layer = FrameBuffer(pf.max_y, pf.max_x);
+    static_layer_stale = true;
 }
 
 void Level::bind_notification_bar(NotificationBar &bar) {
     bar_ptr = &bar;
 }
 
-// Before the player launches the ball, make the ball swing from left to right.
-// When the player presses Space, launch the ball.
-void Level::launch_ball() {
-    int ch = 'a';
-    double period = 90;
-    do {
-        period += 6.28;
-        if (period > 360) {
-            period -= 360;
-        }
-        double offset = std::sin(from_deg(period)) * 0.9;
+// Connects the level to a FrameClock, which paces the frames while the player is playing.
+// Makes room for a key for every tick a frame can have, so that reading keys never allocates.
+// frame_clock: The FrameClock to connect to.
+void Level::bind_frame_clock(FrameClock &frame_clock) {
+    frame_clock_ptr = &frame_clock;
+    frame_keys.reserve(frame_clock.get_max_catch_up());
+}
 
-        ch = wgetch(pf_ptr->get_display_window());
+// Connects the level to an InputRecorder, which records the key of every frame simulated from then on.
+// recorder: The InputRecorder to connect to.
+void Level::bind_recorder(InputRecorder &recorder) {
+    recorder_ptr = &recorder;
+}
 
-        if (ch == 'p' || ch == 'P') {
-            if (pause_menu() == 0) {
-                return;
-            }
-        }
+// Connects the level to an InputReader, which the level takes its keys from instead of ncurses.
+// input: The InputReader to connect to. It must be running while the level is played.
+void Level::bind_input_reader(InputReader &input) {
+    input_ptr = &input;
+}
 
-        paddle.move_by_input(ch, well);
-        for (Ball *ball : balls) {
-            ball->move_to_paddle(paddle, offset);
-        }
+// Connects the level to a FrameProfiler, which times the phases of every frame from then on.
+// profiler: The FrameProfiler to connect to.
+void Level::bind_profiler(FrameProfiler &profiler) {
+    profiler_ptr = &profiler;
+}
+
+// Sets the seed that every random draw in the level comes from.
+// A level with the same seed and the same keys in every frame plays out the same way.
+// seed: The seed.
+void Level::set_seed(unsigned int seed) {
+    Level::seed = seed;
+    seed_loot_tables();
+}
 
-        render_screen();
+// Moves the paddle and keeps the balls on top of it, swinging them from left to right.
+// This is one frame of the aiming phase before the player launches the ball.
+// ch: The key pressed in this frame.
+void Level::aim_ball(int ch) {
+    if (recorder_ptr != NULL) {
+        recorder_ptr->record(ch);
+    }
+
+    launch_period += 6.28;
+    if (launch_period > 360) {
+        launch_period -= 360;
+    }
+    double offset = std::sin(from_deg(launch_period)) * 0.9;
 
-        // Wait for a frame
-        napms(33);
-    } while (ch != ' ');
+    paddle.move_by_input(ch, well);
+    for (Ball *ball : balls) {
+        ball->move_to_paddle(paddle, offset);
+    }
 }
 
-// Simulates one frame of the game.
-void Level::run_loop() {
+// Simulates one frame of the game without reading input or drawing anything.
+// ch: The key pressed in this frame.
+void Level::simulate_frame(int ch) {
+    if (recorder_ptr != NULL) {
+        recorder_ptr->record(ch);
+    }
 
     int init_extra_lifes = game_stat_ptr->get_extra_lives();
 
     // Move
-    int ch = wgetch(pf_ptr->get_display_window());
     paddle.move_by_input(ch, well);
 
     if ((ch == 'c' || ch == 'C') && game_stat_ptr->can_fire_missile()) {
@@ -127,156 +161,141 @@ void Level::run_loop() {
         launch_missile();
     }
 
-    if (ch == 'p' || ch == 'P') {
-        pause_menu();
-    }
-
-    std::set<Ball *> removed_ball;
-    for (Ball *ball : balls) {
-        ball->set_speed_multi(game_stat_ptr->get_speed_multi());
-        move_ball(*ball);
+    {
+        ScopedPhase phase(profiler_ptr, FrameProfiler::MOVE_BALLS);
+        for (size_t i = 0; i < balls.size();) {
+            Ball *ball = balls[i];
+            ball->set_speed_multi(game_stat_ptr->get_speed_multi());
+            move_ball(*ball);
 
-        if (ball->outside_well(well)) {
-            removed_ball.insert(ball);
+            if (ball->outside_well(well)) {
+                delete_ball(ball);
+            } else {
+                ++i;
+            }
         }
     }
 
-    for (Ball *ball : removed_ball) {
-        delete_ball(ball);
-    }
-
     // Check collision of missiles
-    handle_missile();
-
-    // Check collision with power-up drops
-    handle_power_ups();
-    tick_power_up_timers();
-    render_screen();
-
-    if (init_extra_lifes < game_stat_ptr->get_extra_lives()) {
-        bar_ptr->display("Score milestone reached! +1 life");
+    {
+        ScopedPhase phase(profiler_ptr, FrameProfiler::HANDLE_MISSILE);
+        handle_missile();
     }
 
-    bar_ptr->tick();
-}
-
-// Displays everything inside the Level to the main screen (PlayingField).
-void Level::render_screen() {
-    PlayingField pf = *pf_ptr;
-
-    // Clear screen before printing
-    werase(pf.get_display_window());
-    wrefresh(pf.get_display_window());
-
-    game_stat_ptr->draw_display_window();
-
-    // Draw the paddle
-    paddle.draw_pf(pf);
-
-    for (RectWall *i : bricks) {
-        i->draw_to_pf(pf);
+    // Score and remove the bricks broken in this frame
+    {
+        ScopedPhase phase(profiler_ptr, FrameProfiler::REMOVE_BRICKS);
+        remove_broken_block();
     }
 
-    // Draw the missiles
-    for (Missile *m : missiles) {
-        m->draw_pf(pf);
+    // Check collision with power-up drops
+    {
+        ScopedPhase phase(profiler_ptr, FrameProfiler::HANDLE_POWER_UPS);
+        handle_power_ups();
     }
-
-    // Draw the power-up drops
-    for (PowerUpDrop *p : power_up_drops) {
-        p->draw_pf(pf);
+    {
+        ScopedPhase phase(profiler_ptr, FrameProfiler::TICK_TIMERS);
+        tick_power_up_timers();
     }
 
-    // Draw the well
-    well.draw(pf);
-
-    for (Ball *ball : balls) {
-        // Draw the ball
-        ball->draw_pf(pf);
+    if (init_extra_lifes < game_stat_ptr->get_extra_lives()) {
+        bar_ptr->display("Score milestone reached! +1 life");
     }
 
-    wrefresh(pf.get_display_window());
+    bar_ptr->tick();
 }
 
-// Simulates the movement of a Ball in one frame, making it bounce and destroying bricks as needed.
+// Simulates the movement of a Ball in one frame, making it bounce and breaking bricks as needed.
+// The broken bricks are removed at the end of the frame (see remove_broken_block).
+// Instead of moving in small steps, the ball moves straight to the first thing in its path,
+// bounces off it and carries on with the rest of the frame. This way the ball cannot pass through
+// anything however fast it goes, and a frame costs one step per bounce.
 // ball: The ball to simulate.
 void Level::move_ball(Ball &ball) {
 
-    double segments = ball.speed() / ball.max_stepping;
+    double remaining = 1.0;
 
-    for (int i = 0; i < segments; i++) {
-        double travelFactor = std::min(segments - i, 1.0) / segments;
-        ball.move_by_velocity(travelFactor);
+    for (int i = 0; i < max_bounces && remaining > 0; i++) {
+        BallHit hit;
 
-        // Collision checking
-        // Check collision for the wall
-        ball.if_collide_rebound(well, travelFactor);
+        // Check collision for the wall and the paddle
+        ball.find_hit(well, remaining, hit);
+        ball.find_hit(paddle, remaining, hit);
 
-        // Check collision for the paddle
-        ball.if_collide_rebound(paddle, travelFactor);
-
-        // Check collision for all edges in the game field
-        for (RectBlock *i : bricks) {
-            if (!(i->broken)) {
-                // Rebound and mark as broken
-                ball.if_collide_rebound(i, travelFactor);
+        // Check collision for the bricks around the ball's path
+        Vector2 pos = ball.get_pos();
+        Vector2 next_pos = pos.add(ball.vel().scale(remaining));
+        brick_grid.query(Rect::get_bounding_rect(pos, next_pos), nearby_bricks);
+        for (int id : nearby_bricks) {
+            if (!bricks.is_broken(id)) {
+                ball.find_hit(bricks.get_rect(id), id, remaining, hit);
             }
         }
 
-        remove_broken_block();
+        ball.move_by_velocity(remaining * hit.time);
+        remaining -= remaining * hit.time;
+
+        if (hit.type == BallHit::NONE) {
+            break;
+        }
+        // Rebound and mark bricks as broken
+        ball.rebound(hit, well, paddle);
+        if (hit.type == BallHit::BRICK) {
+            bricks.break_brick(hit.brick);
+        }
     }
 }
 
-// Removes all the bricks that have been broken by the Ball.
+// Removes all the bricks that have been broken since the last call, in the order they were broken.
+// This is done once per frame, after the balls and missiles have moved, so it only costs as much as
+// the number of bricks broken in the frame.
 // Drop a power-up for every 5 bricks broken (by default). This value may be changed by the .bl file.
 void Level::remove_broken_block() {
-    std::vector<RectBlock *> broken_blocks;
-
-    // Select broken tile
-    for (auto i = bricks.begin(); i != bricks.end(); ++i) {
-        RectBlock *brick = (*i);
-        if (brick->broken) {
-            broken_blocks.push_back(brick);
+    for (int id : bricks.get_broken_queue()) {
+        if (!bricks.exists(id) || !bricks.is_broken(id)) {
+            continue;
         }
-    }
 
-    // Remove from list
-    for (RectBlock *brick : broken_blocks) {
         // Spawn power-ups
         if ((broke_count - offset) >= 0) {
             if ((broke_count - offset) % drop_freq == 0) {
                 PowerUp pu = loot_table->draw_power_up();
-                Vector2 pos = brick->get_rect().center().add_x(0.5);
-                PowerUpDrop *pud = new PowerUpDrop(pos, 0.1, pu);
-                add_power_up_drop(pud);
+                Vector2 pos = bricks.get_rect(id).center().add_x(0.5);
+                add_power_up_drop(pos, 0.1, pu);
+                trace_instant("power-up dropped", "game", NULL, 0, pu.abbr.c_str());
             }
         }
 
         ++broke_count;
 
-        game_stat_ptr->add_base_score(brick->points);
-        delete_brick(brick);
+        trace_instant("brick broken", "game", "points", bricks.get_points(id));
+        game_stat_ptr->add_base_score(bricks.get_points(id));
+        delete_brick(id);
     }
+    bricks.clear_broken_queue();
 }
 
 // Simulates the falling power-ups in the playing field for one frame.
 void Level::handle_power_ups() {
-    std::vector<PowerUpDrop *> removed;
-    for (auto &pud : power_up_drops) {
+    for (size_t i = 0; i < power_up_drops.size();) {
+        PowerUpDrop *pud = power_up_drops[i];
+        bool removed = false;
         if (pud->collide(paddle)) {
-            removed.push_back(pud);
+            removed = true;
+            ++power_ups_collected[pud->powerup.id];
+            trace_instant("power-up collected", "game", NULL, 0, pud->powerup.abbr.c_str());
             // Extra functions for handling power-up collections
             use_power_up(pud->powerup.id);
         } else {
             pud->move();
-            if (pud->outside_well(well)) {
-                removed.push_back(pud);
-            }
+            removed = pud->outside_well(well);
         }
-    }
 
-    for (PowerUpDrop *pud : removed) {
-        delete_power_up_drop(pud);
+        if (removed) {
+            delete_power_up_drop(pud);
+        } else {
+            ++i;
+        }
     }
 }
 
@@ -292,8 +311,7 @@ void Level::tick_power_up_timers() {
             Rect box = well.get_inner_box();
             Vector2 pos = box.top_center();
 
-            PowerUpDrop *pud = new PowerUpDrop(pos, 0.1, pu);
-            add_power_up_drop(pud);
+            add_power_up_drop(pos, 0.1, pu);
 
             game_stat_ptr->set_pity_timer();
             bar_ptr->display("Pity power-up spawned");
@@ -340,9 +358,9 @@ void Level::use_power_up(int id) {
         game_stat_ptr->add_speed();
         double speed = game_stat_ptr->get_speed_multi();
 
-        std::stringstream ss;
-        ss << ">>> Ball Speed Up (x" << std::fixed << std::setprecision(2) << speed << ")";
-        bar_ptr->display(ss.str());
+        char message[64];
+        std::snprintf(message, sizeof(message), ">>> Ball Speed Up (x%.2f)", speed);
+        bar_ptr->display(message);
 
         return;
     }
@@ -351,9 +369,9 @@ void Level::use_power_up(int id) {
         game_stat_ptr->sub_speed();
         double speed = game_stat_ptr->get_speed_multi();
 
-        std::stringstream ss;
-        ss << "<<< Ball Slow Down (x" << std::fixed << std::setprecision(2) << speed << ")";
-        bar_ptr->display(ss.str());
+        char message[64];
+        std::snprintf(message, sizeof(message), "<<< Ball Slow Down (x%.2f)", speed);
+        bar_ptr->display(message);
         return;
     }
 
@@ -362,10 +380,8 @@ void Level::use_power_up(int id) {
         Vector2 pos = phb.bottom_center().add_y(0.2);
         // Base velocity of two balls, can be changed later.
         // The asymmetry of the balls is intentional.
-        Ball *left = new Ball(pos, {-0.3, 0.5});
-        Ball *right = new Ball(pos, {0.5, 0.3});
-        add_ball(left);
-        add_ball(right);
+        add_ball(pos, {-0.3, 0.5});
+        add_ball(pos, {0.5, 0.3});
 
         bar_ptr->display("Multiball");
         return;
@@ -381,7 +397,9 @@ void Level::use_power_up(int id) {
     if (id == PowerUpList::SHIELD.id) {
         bool success = well.shield.upgrade();
         if (success) {
-            bar_ptr->display("Shield Upgrade Level " + std::to_string(well.shield.get_level()));
+            char message[64];
+            std::snprintf(message, sizeof(message), "Shield Upgrade Level %d", well.shield.get_level());
+            bar_ptr->display(message);
         } else {
             bar_ptr->display("Shield max level reached, no effect.");
         }
@@ -397,14 +415,17 @@ void Level::use_power_up(int id) {
 
 // Simulates the fired missiles for one frame.
 void Level::handle_missile() {
-    std::vector<Missile *> removed;
-    for (auto &missile : missiles) {
+    for (size_t i = 0; i < missiles.size();) {
+        Missile *missile = missiles[i];
+        bool removed = false;
         bool broken = false;
-        for (RectBlock *brick : bricks) {
-            if (!(brick->broken)) {
-                if (missile->collide(brick)) {
-                    brick->break_brick();
-                    removed.push_back(missile);
+        Vector2 pos = missile->get_pos();
+        brick_grid.query({pos, pos}, nearby_bricks);
+        for (int id : nearby_bricks) {
+            if (!bricks.is_broken(id)) {
+                if (missile->collide(bricks.get_rect(id))) {
+                    bricks.break_brick(id);
+                    removed = true;
                     broken = true;
                     break;
                 }
@@ -412,39 +433,28 @@ void Level::handle_missile() {
         }
         if (!broken) {
             missile->move();
-            if (missile->hit_well(well)) {
-                removed.push_back(missile);
-            }
+            removed = missile->hit_well(well);
         }
-    }
-
-    remove_broken_block();
 
-    for (Missile *missile : removed) {
-        delete_missile(missile);
+        if (removed) {
+            delete_missile(missile);
+        } else {
+            ++i;
+        }
     }
 }
 
 // Fires a missile. The missile spawns at the top-centre of the paddle.
 void Level::launch_missile() {
     Rect hitbox = paddle.get_paddle_hitbox();
-    Missile *missile_mid = new Missile(hitbox.top_center(), 0.8);
-    Missile *missile_left = new Missile(hitbox.top_left(), 0.8);
-    Missile *missile_right = new Missile(hitbox.top_right(), 0.8);
-    add_missile(missile_left);
-    add_missile(missile_mid);
-    add_missile(missile_right);
+    add_missile(hitbox.top_left(), 0.8);
+    add_missile(hitbox.top_center(), 0.8);
+    add_missile(hitbox.top_right(), 0.8);
 }
 
-// Returns the remaining number of bricks.
+// Returns the remaining number of bricks that can be broken. Kept up to date by the BrickTable, so it is cheap to call every frame.
 int Level::get_remaining_breakable_blocks() {
-    int count = 0;
-    for (RectBlock *brick : bricks) {
-        if (!brick->unbreakable) {
-            ++count;
-        }
-    }
-    return count;
+    return bricks.count_breakable();
 }
 
 // Returns if all the bricks on the field has been destroyed, i.e. there are 0 bricks left.
@@ -453,96 +463,199 @@ bool Level::all_bricks_destroyed() {
     return get_remaining_breakable_blocks() <= 0;
 }
 
+// Returns the position of the ball closest to the bottom of the well through pos.
+// Returns false (leaving pos untouched) if there are no balls on the field.
+// pos: Output, the position of the lowest ball.
+bool Level::get_lowest_ball_pos(Vector2 &pos) {
+    bool found = false;
+    for (Ball *ball : balls) {
+        Vector2 ball_pos = ball->get_pos();
+        if (!found || ball_pos.y < pos.y) {
+            pos = ball_pos;
+            found = true;
+        }
+    }
+    return found;
+}
+
+// Returns the position of the paddle.
+Vector2 Level::get_paddle_pos() {
+    return paddle.get_pos();
+}
+
 // Returns if there is at least still 1 ball on the field.
 // Used to decide if the player should lose a life.
 bool Level::has_ball() {
-    return balls.size() > 0;
+    return get_ball_count() > 0;
+}
+
+// Returns the number of balls on the field.
+int Level::get_ball_count() {
+    return balls.size();
+}
+
+// Returns the number of power-ups dropping on the field.
+int Level::get_power_up_drop_count() {
+    return power_up_drops.size();
+}
+
+// Returns the number of missiles flying on the field.
+int Level::get_missile_count() {
+    return missiles.size();
+}
+
+// Returns the number of bricks broken in the level so far.
+int Level::get_bricks_broken() {
+    return broke_count;
 }
 
 // Destroys all dynamic objects when a level ends.
 void Level::destroy_objects() {
     destruct_loot_table();
 
-    std::set<Ball *> balls_cp = balls;
-    std::set<RectBlock *> bricks_cp = bricks;
-    std::set<PowerUpDrop *> pud_cp = power_up_drops;
-    std::set<Missile *> missiles_cp = missiles;
-
-    for (Ball *ball : balls_cp) {
-        delete_ball(ball);
+    while (!balls.empty()) {
+        delete_ball(balls.back());
     }
 
-    for (RectBlock *brick : bricks_cp) {
-        delete_brick(brick);
+    bricks.clear();
+    brick_grid.clear();
+    drawn_brick_grid.clear();
+
+    while (!power_up_drops.empty()) {
+        delete_power_up_drop(power_up_drops.back());
     }
 
-    for (PowerUpDrop *pud : pud_cp) {
-        delete_power_up_drop(pud);
+    while (!missiles.empty()) {
+        delete_missile(missiles.back());
     }
+}
 
-    for (Missile *missile : missiles_cp) {
-        delete_missile(missile);
+// Makes room for the most entities that can be on the field, so that adding them never allocates.
+void Level::init_entity_lists() {
+    balls.reserve(max_balls);
+    power_up_drops.reserve(max_power_up_drops);
+    missiles.reserve(max_missiles);
+    // The paddle and every entity
+    drawn_boxes.reserve(1 + max_balls + max_power_up_drops + max_missiles);
+}
+
+// Makes room for every brick to be broken and removed in the same frame, so that breaking bricks and drawing
+// the bricks removed never allocates, and draws the static layer. Called once the bricks are loaded.
+void Level::init_brick_lists() {
+    bricks.reserve_queues();
+    nearby_bricks.reserve(bricks.slot_count());
+    removed_bricks.reserve(bricks.slot_count());
+    dirty_boxes.reserve(drawn_boxes.capacity() + bricks.slot_count());
+    static_layer_stale = true;
+    if (pf_ptr != NULL) {
+        render_static_layer(*pf_ptr);
     }
 }
 
-// Adds a ball to the playing field.
-// ball: The ball to add.
-void Level::add_ball(Ball *ball) {
-    balls.insert(ball);
+// Adds a ball to the playing field. Does nothing if there are already too many balls.
+// pos: The initial ball position.
+// base_vel: The initial ball velocity.
+void Level::add_ball(Vector2 pos, Vector2 base_vel) {
+    Ball *ball = ball_pool.acquire(pos, base_vel);
+    if (ball != NULL) {
+        balls.push_back(ball);
+    }
 }
 
 // Adds a brick to the playing field.
-// brick: The brick to add.
-void Level::add_brick(RectBlock *brick) {
-    bricks.insert(brick);
-    brick->parent_set = &bricks;
+// rect: The rectangle that the brick occupies.
+// clr0: The id of the color of the brick.
+// unbreakable: If true, adds a wall instead, which is unbreakable.
+void Level::add_brick(Rect rect, int clr0, bool unbreakable) {
+    int id = bricks.add(rect, clr0, unbreakable);
+    brick_grid.insert(id, rect);
+    static_layer_stale = true;
 }
 
-// Adds a dropping power-up to the playing field.
-// pud: The dropping power-up to add.
-void Level::add_power_up_drop(PowerUpDrop *pud) {
-    power_up_drops.insert(pud);
+// Adds a dropping power-up to the playing field. Does nothing if there are already too many.
+// pos: The spawning position.
+// move_speed: The power-up's dropping speed.
+// powerup: The type of power-up.
+void Level::add_power_up_drop(Vector2 pos, double move_speed, PowerUp powerup) {
+    ++power_ups_drawn[powerup.id];
+    PowerUpDrop *pud = power_up_drop_pool.acquire(pos, move_speed, powerup);
+    if (pud != NULL) {
+        power_up_drops.push_back(pud);
+    }
 }
 
-// Adds a missile to the playing field.
-// missile: The missile to add.
-void Level::add_missile(Missile *missile) {
-    missiles.insert(missile);
+// Adds a missile to the playing field. Does nothing if there are already too many missiles.
+// pos: The spawning position.
+// move_speed: The distance that the missile moves upwards per frame.
+void Level::add_missile(Vector2 pos, double move_speed) {
+    Missile *missile = missile_pool.acquire(pos, move_speed);
+    if (missile != NULL) {
+        missiles.push_back(missile);
+    }
 }
 
 // Removes a ball from the playing field.
 // ball: The ball to remove.
 void Level::delete_ball(Ball *ball) {
-    balls.erase(ball);
-    delete ball;
+    balls.erase(std::find(balls.begin(), balls.end(), ball));
+    ball_pool.release(ball);
 }
 
-// Removes a brick from the playing field.
-// brick: The brick to remove.
-void Level::delete_brick(RectBlock *brick) {
-    bricks.erase(brick);
-    delete brick;
+// Removes a brick from the playing field. Its cells are cleared on the next render_screen().
+// id: The id of the brick to remove.
+void Level::delete_brick(int id) {
+    removed_bricks.push_back(bricks.get_rect(id));
+    brick_grid.remove(id, bricks.get_rect(id));
+    drawn_brick_grid.remove(id, bricks.get_rect(id));
+    bricks.remove(id);
 }
 
 // Removes a dropping power-up from the playing field.
 // pud: The dropping power-up to remove.
 void Level::delete_power_up_drop(PowerUpDrop *pud) {
-    power_up_drops.erase(pud);
-    delete pud;
+    power_up_drops.erase(std::find(power_up_drops.begin(), power_up_drops.end(), pud));
+    power_up_drop_pool.release(pud);
 }
 
 // Removes a missile from the playing field.
 // missile: The missile to remove.
 void Level::delete_missile(Missile *missile) {
-    missiles.erase(missile);
-    delete missile;
+    missiles.erase(std::find(missiles.begin(), missiles.end(), missile));
+    missile_pool.release(missile);
+}
+
+// Returns the most balls that have been on the field at once.
+int Level::get_peak_balls() {
+    return ball_pool.peak();
+}
+
+// Returns the most dropping power-ups that have been on the field at once.
+int Level::get_peak_power_up_drops() {
+    return power_up_drop_pool.peak();
+}
+
+// Returns the most missiles that have been on the field at once.
+int Level::get_peak_missiles() {
+    return missile_pool.peak();
+}
+
+// Returns how many of a power-up have dropped in the level, including any dropped when the playing field was full.
+// id: The id of the power-up.
+int Level::get_power_ups_drawn(int id) {
+    return power_ups_drawn[id];
+}
+
+// Returns how many of a power-up the paddle has caught in the level.
+// id: The id of the power-up.
+int Level::get_power_ups_collected(int id) {
+    return power_ups_collected[id];
 }
 
 // Creates a new ball at the top-centre of the paddle that initially moves downward.
 void Level::init_ball() {
+    launch_period = 90;
     if (balls.empty()) {
-        Ball *ball = new Ball({0.0, 0.0}, {0.0, -0.6});
-        balls.insert(ball);
+        add_ball({0.0, 0.0}, {0.0, -0.6});
     }
 }
 
@@ -553,20 +666,17 @@ void Level::init_ball() {
 // - Generates a new ball.
 void Level::reset_level() {
 
-    for (Ball *ball : balls) {
-        delete ball;
+    while (!balls.empty()) {
+        delete_ball(balls.back());
     }
-    balls.clear();
 
-    for (PowerUpDrop *pud : power_up_drops) {
-        delete pud;
+    while (!power_up_drops.empty()) {
+        delete_power_up_drop(power_up_drops.back());
     }
-    power_up_drops.clear();
 
-    for (Missile *missile : missiles) {
-        delete missile;
+    while (!missiles.empty()) {
+        delete_missile(missiles.back());
     }
-    missiles.clear();
 
     game_stat_ptr->reset_lv_stats();
     paddle.reset_width(well);
@@ -585,16 +695,3 @@ void Level::set_quit_status(bool status) {
 bool Level::quitted() {
     return is_quitted;
 }
-
-// Pauses the game and opens up the pause menu.
-// Returns the option that the player chose (0 = exit game, 1 = resume).
-int Level::pause_menu() {
-    Menu sample;
-
-    int choice = sample.run_pause_ui();
-
-    if (choice == 0) {
-        set_quit_status(true);
-    }
-    return choice;
-}
\ No newline at end of file
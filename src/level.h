@@ -1,26 +1,43 @@
 #include "ball.h"
+#include "brick_grid.h"
+#include "brick_table.h"
+#include "frame_buffer.h"
+#include "frame_clock.h"
+#include "frame_profiler.h"
 #include "game_stat.h"
+#include "input_reader.h"
+#include "input_recorder.h"
+#include "level_tokenizer.h"
 #include "loot_table.h"
 #include "missile.h"
 #include "notification_bar.h"
+#include "object_pool.h"
 #include "playing_field.h"
 #include "power_up_drop.h"
 #include "rect.h"
-#include "rect_block.h"
 #include "rect_wall.h"
 
-#include <fstream>
-#include <set>
 #include <string>
+#include <vector>
 
 #ifndef LEVEL_H_
 #define LEVEL_H_
 
 class Level {
+    // The benchmarks (see bench_main.cpp) time the private steps of a frame.
+    friend class LevelBenchmarks;
+
     private:
         GameStat *game_stat_ptr = NULL;
         PlayingField *pf_ptr = NULL;
         NotificationBar *bar_ptr = NULL;
+        FrameClock *frame_clock_ptr = NULL;
+        InputRecorder *recorder_ptr = NULL;
+        InputReader *input_ptr = NULL;
+        FrameProfiler *profiler_ptr = NULL;
+
+        // The key for each tick of the current frame.
+        std::vector<int> frame_keys;
 
         bool is_quitted = false;
 
@@ -29,22 +46,85 @@ class Level {
 
         int broke_count = 0, drop_freq = 5, offset = 2, pity_threshold = 80;
 
+        // The most bounces a ball can make in one frame. The rest of its movement in the frame is dropped.
+        const int max_bounces = 16;
+
+        // Swing of the ball on the paddle before it is launched, in degrees.
+        double launch_period = 90;
+
         Well well = Well({-15, -15, 15, 15});
         Paddle paddle = Paddle({0.0, -10.0}, 7.0, 1.0);
 
-        std::set<RectBlock *> bricks;
-        std::set<Ball *> balls;
-        std::set<PowerUpDrop *> power_up_drops;
-        std::set<Missile *> missiles;
+        BrickTable bricks;
+        // Spatial index over the bricks, so that collision checks only look at nearby bricks.
+        BrickGrid brick_grid = BrickGrid({-15.0, -15.0, 15.0, 15.0}, 2.0);
+        // Scratch list for brick_grid lookups, kept to avoid reallocating every lookup.
+        std::vector<int> nearby_bricks;
+        // The most balls, power-up drops and missiles that can be on the field at once.
+        // Anything spawned beyond these limits is dropped.
+        static const int max_balls = 512;
+        static const int max_power_up_drops = 512;
+        static const int max_missiles = 768;
+
+        // Entities are kept in the order they were added, and their memory comes from fixed-size pools,
+        // so spawning and removing them during the game does not allocate.
+        std::vector<Ball *> balls;
+        std::vector<PowerUpDrop *> power_up_drops;
+        std::vector<Missile *> missiles;
+        ObjectPool<Ball> ball_pool{max_balls};
+        ObjectPool<PowerUpDrop> power_up_drop_pool{max_power_up_drops};
+        ObjectPool<Missile> missile_pool{max_missiles};
+
+        // Drawing only what changed (see level_render.cpp).
+        // Whether the next render_screen() has to draw the whole playing field again.
+        bool full_redraw = true;
+        // The shield level when the well was last drawn.
+        int drawn_shield_level = -1;
+        // Whether the bricks were last drawn with reduced detail (see PlayingField::set_reduced_detail()).
+        bool drawn_reduced_detail = false;
+        // Whether the last frame of run_loop() was left undrawn, with reduced detail.
+        bool render_skipped = false;
+        // Cells drawn on by the paddle, balls, missiles and power-ups in the last render_screen().
+        std::vector<CellBox> drawn_boxes;
+        // Cells to clear and draw again in the next render_screen().
+        std::vector<CellBox> dirty_boxes;
+        // Bricks removed since the last render_screen().
+        std::vector<Rect> removed_bricks;
+        // The parts of the playing field that never change during a level (the blank background, the walls
+        // of the well and the unbreakable bricks), drawn once and copied onto the screen where needed.
+        // It is sized when the playing field is bound, and drawn again when the bricks change.
+        FrameBuffer static_layer{0, 0};
+        bool static_layer_stale = true;
+        // Whether each brick (by id) is drawn in the static layer.
+        std::vector<char> static_bricks;
+        // The bricks that are not in the static layer, which are the only ones drawn again when cells are cleared.
+        BrickGrid drawn_brick_grid = BrickGrid({-15.0, -15.0, 15.0, 15.0}, 2.0);
+        // Blocks of cells where a brick outside the static layer lies under a wall or brick in it. The layer is
+        // copied onto them again after the bricks are drawn.
+        std::vector<CellBox> static_overlaps;
+        // The cells each brick (by id) is drawn on, worked out when the static layer is drawn.
+        std::vector<CellBox> brick_ranges;
+
+        void render_static_layer(PlayingField &pf);
+        void add_static_overlaps(PlayingField &pf, CellBox static_range);
+        void render_all(PlayingField &pf);
+        void render_changes(PlayingField &pf);
+        void merge_dirty_boxes();
+        void render_entities(PlayingField &pf);
 
         std::vector<PowerUp> power_up_list;
         LootTable *loot_table = NULL;
         LootTable *pity_table = NULL;
-
-        std::ifstream fin;
+        // Every random draw in the level comes from streams derived from this seed.
+        unsigned int seed = 0;
+        // How many of each power-up were dropped and caught, indexed by power-up id (see PowerUpList).
+        static const int max_power_up_id = 8;
+        int power_ups_drawn[max_power_up_id + 1] = {};
+        int power_ups_collected[max_power_up_id + 1] = {};
 
         void construct_loot_table();
         void destruct_loot_table();
+        void seed_loot_tables();
         void move_ball(Ball &ball);
         void remove_broken_block();
 
@@ -57,15 +137,17 @@ class Level {
         void handle_missile();
         void launch_missile();
 
-        void add_ball(Ball *ball);
-        void add_brick(RectBlock *object);
-        void add_power_up_drop(PowerUpDrop *pud);
-        void add_missile(Missile *missile);
+        void add_ball(Vector2 pos, Vector2 base_vel);
+        void add_brick(Rect rect, int clr0, bool unbreakable);
+        void add_power_up_drop(Vector2 pos, double move_speed, PowerUp powerup);
+        void add_missile(Vector2 pos, double move_speed);
 
         void init_ball();
+        void init_entity_lists();
+        void init_brick_lists();
 
         void delete_ball(Ball *ball);
-        void delete_brick(RectBlock *object);
+        void delete_brick(int id);
         void delete_power_up_drop(PowerUpDrop *pud);
         void delete_missile(Missile *missile);
 
@@ -73,21 +155,21 @@ class Level {
 
         // level loader
 
-        void read_command();
-        bool read_loot_table_command(std::map<PowerUp, int> &loot_map);
-        bool read_pity_table_command(std::map<PowerUp, int> &pity_map);
+        void read_command(LevelTokenizer &tokens, std::map<PowerUp, int> &loot_map, std::map<PowerUp, int> &pity_map);
+        bool read_loot_table_command(LevelTokenizer &tokens, std::map<PowerUp, int> &loot_map);
+        bool read_pity_table_command(LevelTokenizer &tokens, std::map<PowerUp, int> &pity_map);
 
-        void construct_object();
-        void construct_brick(bool unbreakable);
-        void construct_grid_of_bricks();
+        void construct_object(LevelTokenizer &tokens);
+        void construct_brick(LevelTokenizer &tokens, bool unbreakable);
+        void construct_grid_of_bricks(LevelTokenizer &tokens);
 
-        void set_drop_frequency();
-        void set_drop_offset();
-        void set_pity_threshold();
-        void set_power_up_weight(std::map<PowerUp, int> &weights, PowerUp power_up);
+        void set_drop_frequency(LevelTokenizer &tokens);
+        void set_drop_offset(LevelTokenizer &tokens);
+        void set_pity_threshold(LevelTokenizer &tokens);
+        void set_power_up_weight(LevelTokenizer &tokens, std::map<PowerUp, int> &weights, PowerUp power_up);
 
-        void construct_loot_table_from_file();
-        void construct_pity_table_from_file();
+        void construct_loot_table_from_file(LevelTokenizer &tokens, std::map<PowerUp, int> &loot_map);
+        void construct_pity_table_from_file(LevelTokenizer &tokens, std::map<PowerUp, int> &pity_map);
 
     public:
         Level(Rect subject_rect, double x_separation, double y_separation, int x_repeat, int y_repeat);
@@ -96,11 +178,41 @@ class Level {
         void bind_stat(GameStat &game_stat);
         void bind_playing_field(PlayingField &pf);
         void bind_notification_bar(NotificationBar &bar);
+        void bind_frame_clock(FrameClock &frame_clock);
+        void bind_recorder(InputRecorder &recorder);
+        void bind_input_reader(InputReader &input);
+        void bind_profiler(FrameProfiler &profiler);
+        void set_seed(unsigned int seed);
         int load_level_by_file(std::string filename);
+        int load_level_by_text(std::string filename);
+        int load_level_by_text(const char *data, size_t size, std::string source);
+        int load_level_by_image(std::string filename);
+        int load_level_by_image(const char *data, size_t size);
+        std::vector<char> make_level_image();
+        int save_level_image(std::string filename);
 
         void render_screen();
+        void read_keys(int ticks);
         void launch_ball();
-        void run_loop();
+        void run_loop(int ticks);
+
+        void aim_ball(int ch);
+        void simulate_frame(int ch);
+
+        bool get_lowest_ball_pos(Vector2 &pos);
+        Vector2 get_paddle_pos();
+
+        int get_peak_balls();
+        int get_peak_power_up_drops();
+        int get_peak_missiles();
+
+        int get_ball_count();
+        int get_power_up_drop_count();
+        int get_missile_count();
+        int get_bricks_broken();
+
+        int get_power_ups_drawn(int id);
+        int get_power_ups_collected(int id);
 
         bool all_bricks_destroyed();
         bool has_ball();
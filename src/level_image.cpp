@@ -0,0 +1,277 @@
+#include "level_image.h"
+#include "level.h"
+#include "loot_table.h"
+#include "mapped_file.h"
+#include "math_utils.h"
+#include "power_up.h"
+#include "power_up_list.h"
+
+#include <sys/stat.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(LevelImageHeader) % 8 == 0 && sizeof(LevelImageBrick) % 8 == 0 && sizeof(LevelImageWeight) % 8 == 0,
+              "every part of a level image must be a multiple of 8 bytes");
+
+// Returns a FNV-1a style hash of some bytes, used to detect damaged images and level packs.
+// The bytes are hashed 8 at a time, then any bytes left over one at a time.
+// data: The bytes.
+// size: The number of bytes.
+uint32_t level_image_checksum(const char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    for (; i < size; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ull;
+    }
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+// Returns the power-up with an id, or a power-up with id 0 if there is none.
+// id: The id of the power-up.
+PowerUp id_to_power_up(int id) {
+    PowerUp power_ups[] = {PowerUpList::PAD_EXPAND, PowerUpList::PAD_REDUCE, PowerUpList::FAST_BALL, PowerUpList::SLOW_BALL,
+                           PowerUpList::MULTIBALL, PowerUpList::MULTIPLIER, PowerUpList::SHIELD, PowerUpList::MISSILE};
+    for (PowerUp power_up : power_ups) {
+        if (power_up.id == id) {
+            return power_up;
+        }
+    }
+    return {0, "", ""};
+}
+
+// Checks that some bytes are a complete, undamaged level image of the current version
+// that the game can load. Returns true if so, otherwise false with the reason in error.
+// data: The image.
+// size: The size of the image in bytes.
+// &error: Set to the reason why the image cannot be loaded.
+bool check_level_image(const char *data, size_t size, std::string &error) {
+    LevelImageHeader header;
+    if (size < sizeof(header)) {
+        error = "too small to be a compiled level";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, level_image_magic, sizeof(header.magic)) != 0) {
+        error = "not a compiled level";
+        return false;
+    }
+    if (header.version != level_image_version) {
+        error = "compiled for version " + std::to_string(header.version) +
+                ", expected version " + std::to_string(level_image_version);
+        return false;
+    }
+    if (header.byte_order != level_image_byte_order) {
+        error = "compiled on a machine with a different byte order";
+        return false;
+    }
+
+    size_t expected = sizeof(LevelImageHeader) + (size_t)header.brick_count * sizeof(LevelImageBrick) +
+                      ((size_t)header.loot_count + header.pity_count) * sizeof(LevelImageWeight);
+    if (header.size != size || expected != size) {
+        error = "truncated or has the wrong size";
+        return false;
+    }
+    if (level_image_checksum(data + sizeof(header), size - sizeof(header)) != header.checksum) {
+        error = "checksum does not match";
+        return false;
+    }
+    if (header.drop_freq <= 0) {
+        error = "power-up drop frequency must be positive";
+        return false;
+    }
+
+    // The same checks as the text loader, so that a damaged image with a good checksum is not trusted more
+    for (uint32_t i = 0; i < header.brick_count; i++) {
+        LevelImageBrick brick;
+        std::memcpy(&brick, data + sizeof(header) + i * sizeof(brick), sizeof(brick));
+        if (brick.clr0 < 0 || brick.clr0 > 63) {
+            error = "has a brick with a color id outside 0 to 63";
+            return false;
+        }
+        if (!std::isfinite(brick.x1) || !std::isfinite(brick.y1) || !std::isfinite(brick.x2) ||
+            !std::isfinite(brick.y2)) {
+            error = "has a brick whose position is not a finite number";
+            return false;
+        }
+    }
+
+    const char *weights = data + sizeof(header) + header.brick_count * sizeof(LevelImageBrick);
+    for (uint32_t i = 0; i < header.loot_count + header.pity_count; i++) {
+        LevelImageWeight weight;
+        std::memcpy(&weight, weights + i * sizeof(weight), sizeof(weight));
+        if (id_to_power_up(weight.power_up_id).id == 0 || weight.weight <= 0) {
+            error = "has a bad loot table entry";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads a loot table out of a level image.
+// data: Where the weights of the table start.
+// count: The number of weights.
+std::map<PowerUp, int> read_image_weights(const char *data, uint32_t count) {
+    std::map<PowerUp, int> weights;
+    for (uint32_t i = 0; i < count; i++) {
+        LevelImageWeight weight;
+        std::memcpy(&weight, data + i * sizeof(weight), sizeof(weight));
+        weights[id_to_power_up(weight.power_up_id)] = weight.weight;
+    }
+    return weights;
+}
+
+// Adds a loot table to a level image.
+// image: The image to add to.
+// weights: The loot table.
+void write_image_weights(std::vector<char> &image, std::map<PowerUp, int> weights) {
+    for (std::map<PowerUp, int>::iterator i = weights.begin(); i != weights.end(); i++) {
+        LevelImageWeight weight = {i->first.id, i->second};
+        image.insert(image.end(), (char *)&weight, (char *)&weight + sizeof(weight));
+    }
+}
+
+// Loads a level from a compiled level (.blc) file. Returns 0 if the level is successfully loaded, 1 otherwise.
+// The file is read in one go (or mapped, if large), then loaded as below.
+// filename: The address of the file to be opened.
+int Level::load_level_by_image(std::string filename) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return 1;
+    }
+    return load_level_by_image(file.data(), file.size());
+}
+
+// Loads a level from a compiled level in memory, e.g. from a level pack. Returns 0 if the level is successfully loaded, 1 otherwise.
+// The image is checked, then the bricks are copied into the level in one pass.
+// Nothing is loaded if the image is damaged or was compiled for another version.
+// data: The image.
+// size: The size of the image in bytes.
+int Level::load_level_by_image(const char *data, size_t size) {
+    if (game_stat_ptr == NULL || pf_ptr == NULL) {
+        return 1;
+    }
+
+    std::string error;
+    if (!check_level_image(data, size, error)) {
+        return 1;
+    }
+
+    LevelImageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    drop_freq = header.drop_freq;
+    offset = header.offset;
+    pity_threshold = header.pity_threshold;
+
+    const char *cur = data + sizeof(header);
+    bricks.reserve(bricks.slot_count() + header.brick_count);
+    for (uint32_t i = 0; i < header.brick_count; i++) {
+        LevelImageBrick brick;
+        std::memcpy(&brick, cur, sizeof(brick));
+        cur += sizeof(brick);
+        bricks.add({brick.x1, brick.y1, brick.x2, brick.y2}, brick.clr0, brick.unbreakable != 0, brick.points);
+    }
+
+    // Most levels keep the default tables, which are already built
+    std::map<PowerUp, int> loot_weights = read_image_weights(cur, header.loot_count);
+    if (!loot_weights.empty() && loot_weights != loot_table->get_weights()) {
+        delete loot_table;
+        loot_table = new LootTable(loot_weights);
+        loot_table->seed(derive_seed(seed, 0));
+    }
+    cur += header.loot_count * sizeof(LevelImageWeight);
+    std::map<PowerUp, int> pity_weights = read_image_weights(cur, header.pity_count);
+    if (!pity_weights.empty() && pity_weights != pity_table->get_weights()) {
+        delete pity_table;
+        pity_table = new LootTable(pity_weights);
+        pity_table->seed(derive_seed(seed, 1));
+    }
+
+    brick_grid.build(bricks);
+    init_brick_lists();
+    return 0;
+}
+
+// Returns the level compiled into an image, which loads the same level as the .bl file it came from.
+std::vector<char> Level::make_level_image() {
+    std::map<PowerUp, int> loot_weights = loot_table->get_weights();
+    std::map<PowerUp, int> pity_weights = pity_table->get_weights();
+
+    LevelImageHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, level_image_magic, sizeof(header.magic));
+    header.version = level_image_version;
+    header.byte_order = level_image_byte_order;
+    header.drop_freq = drop_freq;
+    header.offset = offset;
+    header.pity_threshold = pity_threshold;
+    header.brick_count = bricks.count_bricks();
+    header.loot_count = loot_weights.size();
+    header.pity_count = pity_weights.size();
+
+    std::vector<char> image(sizeof(header));
+    for (int id = 0; id < bricks.slot_count(); id++) {
+        if (!bricks.exists(id)) {
+            continue;
+        }
+        Rect rect = bricks.get_rect(id);
+        LevelImageBrick brick;
+        std::memset(&brick, 0, sizeof(brick));
+        brick.x1 = rect.pos1.x;
+        brick.y1 = rect.pos1.y;
+        brick.x2 = rect.pos2.x;
+        brick.y2 = rect.pos2.y;
+        brick.clr0 = bricks.get_color(id);
+        brick.unbreakable = bricks.is_unbreakable(id) ? 1 : 0;
+        brick.points = bricks.get_points(id);
+        image.insert(image.end(), (char *)&brick, (char *)&brick + sizeof(brick));
+    }
+    write_image_weights(image, loot_weights);
+    write_image_weights(image, pity_weights);
+
+    header.size = image.size();
+    header.checksum = level_image_checksum(image.data() + sizeof(header), image.size() - sizeof(header));
+    std::memcpy(image.data(), &header, sizeof(header));
+    return image;
+}
+
+// Saves the level as a compiled level (.blc) file. Returns 0 if the file is successfully written, 1 otherwise.
+// filename: The address of the file to write.
+int Level::save_level_image(std::string filename) {
+    std::vector<char> image = make_level_image();
+    std::ofstream fout(filename, std::ios::binary);
+    fout.write(image.data(), image.size());
+    fout.close();
+    return fout.fail() ? 1 : 0;
+}
+
+// Returns if a compiled level (.blc) file exists next to a .bl file, and is newer than it. The times are compared
+// to the nanosecond, and a tie counts as stale, as the .bl file may have been edited just after it was compiled.
+// bl_filename: The address of the .bl file.
+// &blc_filename: Set to the address of the compiled level.
+bool has_fresh_level_image(std::string bl_filename, std::string &blc_filename) {
+    blc_filename = bl_filename + "c";
+    struct stat bl_info, blc_info;
+    if (stat(blc_filename.c_str(), &blc_info) != 0) {
+        return false;
+    }
+    if (stat(bl_filename.c_str(), &bl_info) != 0) {
+        return true;
+    }
+    if (blc_info.st_mtim.tv_sec != bl_info.st_mtim.tv_sec) {
+        return blc_info.st_mtim.tv_sec > bl_info.st_mtim.tv_sec;
+    }
+    return blc_info.st_mtim.tv_nsec > bl_info.st_mtim.tv_nsec;
+}
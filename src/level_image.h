@@ -0,0 +1,54 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifndef LEVEL_IMAGE_H_
+#define LEVEL_IMAGE_H_
+
+// A compiled level (.blc file) is a binary image of a level after its .bl file has been run:
+// every brick of every grid already laid out, the loot tables and the drop settings.
+// It is written by the blc tool (see blc_main.cpp) and loaded by Level::load_level_by_image().
+//
+// Layout, in the byte order of the machine that compiled it:
+// LevelImageHeader, then brick_count LevelImageBrick, then loot_count and pity_count LevelImageWeight.
+// Every part has a size that is a multiple of 8 bytes, so the bricks stay aligned.
+
+const char level_image_magic[4] = {'B', 'L', 'C', '\n'};
+// Increase this whenever the layout changes. Images of other versions are rejected.
+const uint32_t level_image_version = 1;
+// Written as a number, and read back the same only on machines with the same byte order.
+const uint32_t level_image_byte_order = 0x01020304;
+
+struct LevelImageHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    // The size of the whole image in bytes.
+    uint32_t size;
+    // Checksum (see level_image_checksum) of everything after the header.
+    uint32_t checksum;
+
+    int32_t drop_freq, offset, pity_threshold;
+    uint32_t brick_count, loot_count, pity_count;
+    uint32_t reserved;
+};
+
+struct LevelImageBrick {
+    double x1, y1, x2, y2;
+    int32_t clr0;
+    int32_t unbreakable;
+    int32_t points;
+    int32_t reserved;
+};
+
+// The weight of one power-up in a loot table.
+struct LevelImageWeight {
+    int32_t power_up_id;
+    int32_t weight;
+};
+
+uint32_t level_image_checksum(const char *data, size_t size);
+bool check_level_image(const char *data, size_t size, std::string &error);
+bool has_fresh_level_image(std::string bl_filename, std::string &blc_filename);
+
+#endif
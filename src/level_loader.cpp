@@ -1,136 +1,141 @@
 #include "level.h"
+#include "level_image.h"
+#include "level_tokenizer.h"
 #include "loot_table.h"
+#include "mapped_file.h"
+#include "math_utils.h"
 #include "power_up_list.h"
 #include "rect.h"
-#include "rect_block.h"
+#include "brick_table.h"
 
-#include <fstream>
 #include <map>
 #include <stdexcept>
 #include <string>
 
 // Returns the power-up object corresponding to a 3-letter abbreviation.
 // Refer to power_up_list.cpp for the abbreviations.
+// The function throws a runtime error if the abbreviation is not one of them.
+// tokens: The tokenizer that read the abbreviation, used to say where the error is.
 // abbr: The 3-letter abbreviation.
-PowerUp abbr_to_power_up(std::string abbr) {
-    if (abbr == PowerUpList::PAD_EXPAND.abbr) {
-        return PowerUpList::PAD_EXPAND;
-    }
-    if (abbr == PowerUpList::PAD_REDUCE.abbr) {
-        return PowerUpList::PAD_REDUCE;
-    }
-    if (abbr == PowerUpList::FAST_BALL.abbr) {
-        return PowerUpList::FAST_BALL;
-    }
-    if (abbr == PowerUpList::SLOW_BALL.abbr) {
-        return PowerUpList::SLOW_BALL;
-    }
-    if (abbr == PowerUpList::MULTIBALL.abbr) {
-        return PowerUpList::MULTIBALL;
-    }
-    if (abbr == PowerUpList::MULTIPLIER.abbr) {
-        return PowerUpList::MULTIPLIER;
-    }
-    if (abbr == PowerUpList::SHIELD.abbr) {
-        return PowerUpList::SHIELD;
-    }
-    if (abbr == PowerUpList::MISSILE.abbr) {
-        return PowerUpList::MISSILE;
+PowerUp abbr_to_power_up(LevelTokenizer &tokens, const LevelToken &abbr) {
+    const PowerUp *power_ups[] = {&PowerUpList::PAD_EXPAND, &PowerUpList::PAD_REDUCE, &PowerUpList::FAST_BALL, &PowerUpList::SLOW_BALL,
+                                  &PowerUpList::MULTIBALL, &PowerUpList::MULTIPLIER, &PowerUpList::SHIELD, &PowerUpList::MISSILE};
+    for (const PowerUp *power_up : power_ups) {
+        if (abbr.is(power_up->abbr.c_str())) {
+            return *power_up;
+        }
     }
 
-    throw std::runtime_error("Unrecognized power up id: " + abbr);
+    throw tokens.error(abbr, "unrecognized command or power up id \"" + abbr.str() + "\"");
+}
+
+// Reads the next color id and checks that it is one of the color pairs set up by the game (0 to 63).
+// tokens: The tokenizer to read from.
+int read_color(LevelTokenizer &tokens) {
+    LevelToken token = tokens.next("a color id");
+    int clr0 = tokens.to_int(token, "a color id");
+    if (clr0 < 0 || clr0 > 63) {
+        throw tokens.error(token, "color id must be between 0 and 63, got " + token.str());
+    }
+    return clr0;
 }
 
-// Reads the next word in the ifstream and performs actions if it is one of the following keywords:
+// Reads the next word and performs actions if it is one of the following keywords:
 // "cst": The function checks for the next argument and decides what to construct in the level.
 // "loots": The level loader starts modifying the power-up drops from bricks.
 // "pity": The level loader starts modifying the power-up drops from the pity system.
-void Level::read_command() {
-    std::string cmd;
-    fin >> cmd;
-    if (cmd == "cst") {
-        construct_object();
-    } else if (cmd == "loots") {
-        construct_loot_table_from_file();
-    } else if (cmd == "pity") {
-        construct_pity_table_from_file();
+// Any other word is an error.
+//
+// tokens: The tokenizer to read from.
+// loot_map: Set to the weights of the last custom brick loot table.
+// pity_map: Set to the weights of the last custom pity loot table.
+void Level::read_command(LevelTokenizer &tokens, std::map<PowerUp, int> &loot_map, std::map<PowerUp, int> &pity_map) {
+    LevelToken cmd = tokens.next("a command");
+    if (cmd.is("cst")) {
+        construct_object(tokens);
+    } else if (cmd.is("loots")) {
+        construct_loot_table_from_file(tokens, loot_map);
+    } else if (cmd.is("pity")) {
+        construct_pity_table_from_file(tokens, pity_map);
+    } else {
+        throw tokens.error(cmd, "unknown command \"" + cmd.str() + "\", expected cst, loots or pity");
     }
 }
 
-// Reads the next word in the ifstream and performs actions if it is one of the following keywords:
+// Reads the next word and performs actions if it is one of the following keywords:
 // "fin": Finish modifying the power-up drops from bricks.
 // "freq": Adjust the frequency of power-up drops.
 // "offset": Adjust the offset of power-up drops. See set_drop_offset() for details.
 // a power-up abbreviation: Adjust the weight of the power-up in the loot table.
 //
+// tokens: The tokenizer to read from.
 // loot_map: A map that records the weights of power-ups from bricks. Modified by this function.
-bool Level::read_loot_table_command(std::map<PowerUp, int> &loot_map) {
-    std::string cmd;
-    fin >> cmd;
-    if (cmd == "fin") {
+bool Level::read_loot_table_command(LevelTokenizer &tokens, std::map<PowerUp, int> &loot_map) {
+    LevelToken cmd = tokens.next("fin, freq, offset or a power up id");
+    if (cmd.is("fin")) {
         return false;
-    } else if (cmd == "freq") {
-        set_drop_frequency();
-    } else if (cmd == "offset") {
-        set_drop_offset();
+    } else if (cmd.is("freq")) {
+        set_drop_frequency(tokens);
+    } else if (cmd.is("offset")) {
+        set_drop_offset(tokens);
     } else {
-        set_power_up_weight(loot_map, abbr_to_power_up(cmd));
+        set_power_up_weight(tokens, loot_map, abbr_to_power_up(tokens, cmd));
     }
     return true;
 }
 
-// Reads the next word in the ifstream and performs actions if it is one of the following keywords:
+// Reads the next word and performs actions if it is one of the following keywords:
 // "fin": Finish modifying the power-up drops from the pity system.
 // "threshold": Change the threshold of bricks to clear before free power-ups appear.
 // a power-up abbreviation: Adjust the weight of the power-up in the loot table.
 //
+// tokens: The tokenizer to read from.
 // pity_map: A map that records the weights of power-ups from the pity system. Modified by this function.
-bool Level::read_pity_table_command(std::map<PowerUp, int> &pity_map) {
-    std::string cmd;
-    fin >> cmd;
-    if (cmd == "fin") {
+bool Level::read_pity_table_command(LevelTokenizer &tokens, std::map<PowerUp, int> &pity_map) {
+    LevelToken cmd = tokens.next("fin, threshold or a power up id");
+    if (cmd.is("fin")) {
         return false;
-    } else if (cmd == "threshold") {
-        set_pity_threshold();
+    } else if (cmd.is("threshold")) {
+        set_pity_threshold(tokens);
     } else {
-        set_power_up_weight(pity_map, abbr_to_power_up(cmd));
+        set_power_up_weight(tokens, pity_map, abbr_to_power_up(tokens, cmd));
     }
     return true;
 }
 
-// Constructs an object in the level. The ifstream reads the next word and decides what to construct:
+// Constructs an object in the level. The tokenizer reads the next word and decides what to construct:
 // "rbk": Constructs a brick. This requires 5 arguments.
 // "wal": Constructs a wall. This requires 5 arguments.
 // "lvl": Constructs a grid of bricks. This requires 9 arguments.
-void Level::construct_object() {
-    std::string cmd;
-    fin >> cmd;
-    if (cmd == "rbk") {
-        construct_brick(false);
-    } else if (cmd == "wal") {
-        construct_brick(true);
-    } else if (cmd == "lvl") {
-        construct_grid_of_bricks();
+// tokens: The tokenizer to read from.
+void Level::construct_object(LevelTokenizer &tokens) {
+    LevelToken cmd = tokens.next("rbk, wal or lvl");
+    if (cmd.is("rbk")) {
+        construct_brick(tokens, false);
+    } else if (cmd.is("wal")) {
+        construct_brick(tokens, true);
+    } else if (cmd.is("lvl")) {
+        construct_grid_of_bricks(tokens);
+    } else {
+        throw tokens.error(cmd, "unknown object \"" + cmd.str() + "\", expected rbk, wal or lvl");
     }
 }
 
-// Constructs a brick. The ifstream reads the next 5 arguments, which are:
+// Constructs a brick. The tokenizer reads the next 5 arguments, which are:
 // x-coordinate of the brick's left side, y-coordinate of the brick's bottom,
 // x-coordinate of the brick's right side, y-coordinate of the brick's top, the brick's color's id.
+// tokens: The tokenizer to read from.
 // unbreakable: If true, constructs a wall instead, which is unbreakble.
-void Level::construct_brick(bool unbreakable) {
-    double arg_x1, arg_y1, arg_x2, arg_y2;
-    int arg_clr0;
-    fin >> arg_x1 >> arg_y1 >> arg_x2 >> arg_y2 >> arg_clr0;
-    RectBlock *newBrick = new RectBlock({arg_x1, arg_y1, arg_x2, arg_y2}, arg_clr0);
-    if (unbreakable) {
-        newBrick->set_draw_pattern(1);
-        newBrick->unbreakable = true;
-    }
-    add_brick(newBrick);
+void Level::construct_brick(LevelTokenizer &tokens, bool unbreakable) {
+    double arg_x1 = tokens.next_double("the left side");
+    double arg_y1 = tokens.next_double("the bottom");
+    double arg_x2 = tokens.next_double("the right side");
+    double arg_y2 = tokens.next_double("the top");
+    int arg_clr0 = read_color(tokens);
+    bricks.add({arg_x1, arg_y1, arg_x2, arg_y2}, arg_clr0, unbreakable);
 }
 
-// Constructs a grid of bricks. The ifstream reads the next 9 arguments.
+// Constructs a grid of bricks. The tokenizer reads the next 9 arguments.
 //
 // The first 4 arguments define the top-left brick in the grid:
 // x-coordinate of the brick's left side, y-coordinate of the brick's bottom,
@@ -139,94 +144,166 @@ void Level::construct_brick(bool unbreakable) {
 // The next 5 arguments apply to all bricks in the grid:
 // horizontal distance between centres of bricks, vertical distance between centres of bricks,
 // number of rows in the grid, number of columns in the grid, the bricks' color's id.
-void Level::construct_grid_of_bricks() {
-    double arg_x1, arg_y1, arg_x2, arg_y2;
-    int arg_clr0;
-    double arg_x_sep, arg_y_sep;
-    int arg_x_repeat, arg_y_repeat;
+// tokens: The tokenizer to read from.
+void Level::construct_grid_of_bricks(LevelTokenizer &tokens) {
+    double arg_x1 = tokens.next_double("the left side");
+    double arg_y1 = tokens.next_double("the bottom");
+    double arg_x2 = tokens.next_double("the right side");
+    double arg_y2 = tokens.next_double("the top");
+    double arg_x_sep = tokens.next_double("the horizontal separation");
+    double arg_y_sep = tokens.next_double("the vertical separation");
 
-    fin >> arg_x1 >> arg_y1 >> arg_x2 >> arg_y2 >> arg_x_sep >> arg_y_sep >> arg_x_repeat >> arg_y_repeat >> arg_clr0;
+    LevelToken x_repeat = tokens.next("the number of bricks across");
+    int arg_x_repeat = tokens.to_int(x_repeat, "the number of bricks across");
+    LevelToken y_repeat = tokens.next("the number of bricks down");
+    int arg_y_repeat = tokens.to_int(y_repeat, "the number of bricks down");
+    if (arg_x_repeat < 0) {
+        throw tokens.error(x_repeat, "a grid cannot have a negative number of bricks");
+    }
+    if (arg_y_repeat < 0) {
+        throw tokens.error(y_repeat, "a grid cannot have a negative number of bricks");
+    }
+    int arg_clr0 = read_color(tokens);
 
-    RectBlock::create_rectblocks(bricks, {arg_x1, arg_y1, arg_x2, arg_y2}, arg_x_sep, arg_y_sep, arg_x_repeat, arg_y_repeat, arg_clr0);
+    bricks.add_grid({arg_x1, arg_y1, arg_x2, arg_y2}, arg_x_sep, arg_y_sep, arg_x_repeat, arg_y_repeat, arg_clr0);
 }
 
-// Reads the next number in the ifstream and sets the power-up drop frequency to it.
+// Reads the next number and sets the power-up drop frequency to it.
 // The default is 5, which means every 5 bricks drop a power-up.
 // The frequency must be positive. The function throws a runtime error if this is not the case.
-void Level::set_drop_frequency() {
-    fin >> drop_freq;
+// tokens: The tokenizer to read from.
+void Level::set_drop_frequency(LevelTokenizer &tokens) {
+    LevelToken token = tokens.next("the power-up drop frequency");
+    drop_freq = tokens.to_int(token, "the power-up drop frequency");
     if (drop_freq <= 0) {
-        throw std::runtime_error("Power-up drop frequency must be positive");
+        throw tokens.error(token, "power-up drop frequency must be positive");
     }
 }
 
-// Reads the next number in the ifstream and sets the power-up drop offset to it.
+// Reads the next number and sets the power-up drop offset to it.
 // The default is 2, which means the first power-up is from the 3rd block.
 // Setting the offset to n makes the first power-up appear from the (n+1)th block.
-void Level::set_drop_offset() {
-    fin >> offset;
+// tokens: The tokenizer to read from.
+void Level::set_drop_offset(LevelTokenizer &tokens) {
+    offset = tokens.next_int("the power-up drop offset");
 }
 
-// Reads the next number in the ifstream and sets the pity threshold to it.
+// Reads the next number and sets the pity threshold to it.
 // The default is 80, which means after 80% of the bricks are broken, free power-ups start dropping.
-void Level::set_pity_threshold() {
-    fin >> pity_threshold;
+// tokens: The tokenizer to read from.
+void Level::set_pity_threshold(LevelTokenizer &tokens) {
+    pity_threshold = tokens.next_int("the pity threshold");
 }
 
-// Reads the next number in the ifstream and sets the weight of a power-up to it.
+// Reads the next number and sets the weight of a power-up to it.
 // The probability of a drop being picked is its weight divided by the total weight in the table.
+// The weight must be positive. The function throws a runtime error if this is not the case.
+// tokens: The tokenizer to read from.
 // weights: A map that records the weights of power-ups. Modified by this function.
 // power_up: The power-up to change the weight for.
-void Level::set_power_up_weight(std::map<PowerUp, int> &weights, PowerUp power_up) {
-    fin >> weights[power_up];
+void Level::set_power_up_weight(LevelTokenizer &tokens, std::map<PowerUp, int> &weights, PowerUp power_up) {
+    LevelToken token = tokens.next("the power-up weight");
+    weights[power_up] = tokens.to_int(token, "the power-up weight");
+    if (weights[power_up] <= 0) {
+        throw tokens.error(token, "weight of " + power_up.abbr + " must be positive");
+    }
 }
 
-// Sets the brick power-up drop loot table to a custom one defined in the .bl file.
-// The ifstream starts interpreting commands for the table until it reads "fin".
-void Level::construct_loot_table_from_file() {
-    std::map<PowerUp, int> loot_map;
-    while (read_loot_table_command(loot_map)) {
+// Reads a custom brick power-up drop loot table defined in the .bl file.
+// The tokenizer starts interpreting commands for the table until it reads "fin".
+// tokens: The tokenizer to read from.
+// loot_map: Set to the weights in the table, unless the table is empty.
+void Level::construct_loot_table_from_file(LevelTokenizer &tokens, std::map<PowerUp, int> &loot_map) {
+    std::map<PowerUp, int> table_map;
+    while (read_loot_table_command(tokens, table_map)) {
         continue;
     }
-    if (loot_map.size() >= 1) {
-        if (loot_table != NULL) {
-            delete loot_table;
-        }
-        loot_table = new LootTable(loot_map);
+    if (table_map.size() >= 1) {
+        loot_map = table_map;
     }
 }
 
-// Sets the free power-up drop loot table to a custom one defined in the .bl file.
-// The ifstream starts interpreting commands for the table until it reads "fin".
-void Level::construct_pity_table_from_file() {
-    std::map<PowerUp, int> pity_map;
-    while (read_pity_table_command(pity_map)) {
+// Reads a custom free power-up drop loot table defined in the .bl file.
+// The tokenizer starts interpreting commands for the table until it reads "fin".
+// tokens: The tokenizer to read from.
+// pity_map: Set to the weights in the table, unless the table is empty.
+void Level::construct_pity_table_from_file(LevelTokenizer &tokens, std::map<PowerUp, int> &pity_map) {
+    std::map<PowerUp, int> table_map;
+    while (read_pity_table_command(tokens, table_map)) {
         continue;
     }
-    if (pity_map.size() >= 1) {
-        if (pity_table != NULL) {
-            delete pity_table;
-        }
-        pity_table = new LootTable(pity_map);
+    if (table_map.size() >= 1) {
+        pity_map = table_map;
     }
 }
 
-// Loads a level from a .bl file. Returns 0 if the level is successfully loaded, 1 otherwise.
-// The .bl file is read using an ifstream, and works similarly to shell scripts.
-// The ifstream looks for command names and their arguments, until EOF is reached.
+// Loads a level from a file. Returns 0 if the level is successfully loaded, 1 otherwise.
+// A compiled level (.blc) file is loaded directly. For a .bl file, the compiled level next to it
+// is loaded instead if it is newer, and the .bl file is only read if that fails.
 // filename: The address of the file to be opened.
 int Level::load_level_by_file(std::string filename) {
+    std::string blc_filename;
+    if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".blc") == 0) {
+        return load_level_by_image(filename);
+    }
+    if (has_fresh_level_image(filename, blc_filename) && load_level_by_image(blc_filename) == 0) {
+        return 0;
+    }
+    return load_level_by_text(filename);
+}
+
+// Loads a level from a .bl file. Returns 0 if the level is successfully loaded, 1 if the file cannot be opened.
+// The file is read in one go (or mapped, if large) and parsed in place. See the function below for the language.
+// filename: The address of the file to be opened.
+int Level::load_level_by_text(std::string filename) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return 1;
+    }
+    return load_level_by_text(file.data(), file.size(), filename);
+}
+
+// Loads a level from the contents of a .bl file. Returns 0 if the level is successfully loaded, 1 otherwise.
+// The .bl file works similarly to shell scripts: a list of commands and their arguments, separated by whitespace.
+// If the file has any mistake, such as an unknown command, a missing argument or a bad number,
+// the function throws a runtime error that says where the mistake is, and nothing is loaded.
+// data: The contents of the file. They need not end with '\0'.
+// size: The size of the contents in bytes.
+// source: The name of the file, shown in errors.
+int Level::load_level_by_text(const char *data, size_t size, std::string source) {
 
     if (game_stat_ptr == NULL || pf_ptr == NULL) {
         return 1;
     }
 
-    fin.open(filename);
+    int old_drop_freq = drop_freq, old_offset = offset, old_pity_threshold = pity_threshold;
+    std::map<PowerUp, int> loot_map, pity_map;
+    LevelTokenizer tokens(data, size, source);
+    try {
+        while (!tokens.at_end()) {
+            read_command(tokens, loot_map, pity_map);
+        }
+    } catch (std::runtime_error &e) {
+        // Undo what was loaded before the mistake
+        bricks.clear();
+        drop_freq = old_drop_freq;
+        offset = old_offset;
+        pity_threshold = old_pity_threshold;
+        throw;
+    }
 
-    while (!fin.eof()) {
-        read_command();
+    if (loot_map.size() >= 1) {
+        delete loot_table;
+        loot_table = new LootTable(loot_map);
+        loot_table->seed(derive_seed(seed, 0));
+    }
+    if (pity_map.size() >= 1) {
+        delete pity_table;
+        pity_table = new LootTable(pity_map);
+        pity_table->seed(derive_seed(seed, 1));
     }
 
-    fin.close();
+    brick_grid.build(bricks);
+    init_brick_lists();
     return 0;
-}
\ No newline at end of file
+}
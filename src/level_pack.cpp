@@ -0,0 +1,168 @@
+#include "level_image.h"
+#include "level_pack.h"
+#include "mapped_file.h"
+
+#include <sys/stat.h>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Opens a level pack and reads its table of contents. Returns true if the pack can be used.
+// The pack is opened once and kept open; the entries themselves are only checked when they are read.
+// filename: The address of the pack.
+bool LevelPack::open(std::string filename) {
+    entries.clear();
+    entry_ids.clear();
+    checked.clear();
+    stale.clear();
+    if (!file.open(filename) || stat(filename.c_str(), &pack_info) != 0) {
+        file.close();
+        return false;
+    }
+
+    LevelPackHeader header;
+    if (file.size() < sizeof(header)) {
+        file.close();
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    size_t toc_size = (size_t)header.entry_count * sizeof(LevelPackEntry);
+    if (std::memcmp(header.magic, level_pack_magic, sizeof(header.magic)) != 0 ||
+        header.version != level_pack_version || header.byte_order != level_image_byte_order ||
+        header.size != file.size() || sizeof(header) + toc_size > file.size() ||
+        level_image_checksum(file.data() + sizeof(header), toc_size) != header.toc_checksum) {
+        file.close();
+        return false;
+    }
+
+    entries.resize(header.entry_count);
+    std::memcpy(entries.data(), file.data() + sizeof(header), toc_size);
+    for (size_t i = 0; i < entries.size(); i++) {
+        LevelPackEntry &entry = entries[i];
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        if (entry.offset > file.size() || entry.size > file.size() - entry.offset) {
+            entries.clear();
+            entry_ids.clear();
+            file.close();
+            return false;
+        }
+        entry_ids[entry.name] = i;
+    }
+    checked.assign(entries.size(), false);
+    stale.assign(entries.size(), false);
+    return true;
+}
+
+// Returns if a level pack has been opened successfully.
+bool LevelPack::is_open() {
+    return file.size() > 0;
+}
+
+// Returns the names of the levels in the pack, in the order they are played.
+std::vector<std::string> LevelPack::get_level_names() {
+    std::vector<std::string> names;
+    for (LevelPackEntry &entry : entries) {
+        if (entry.kind == LEVEL) {
+            names.push_back(entry.name);
+        }
+    }
+    return names;
+}
+
+// Returns if the pack has an entry with a name.
+// name: The name of the entry, e.g. "data/default.bl".
+bool LevelPack::has(std::string name) {
+    return entry_ids.count(name) > 0;
+}
+
+// Finds the contents of an entry. Returns true if it is found, undamaged and up to date.
+// An entry whose loose file has been changed since the pack was built is out of date, so that an edited level
+// is not hidden by an old pack; the caller then reads the loose file instead.
+// The contents are not copied, and stay valid while the pack is open.
+// name: The name of the entry, e.g. "data/default.bl".
+// &data: Set to where the contents start.
+// &size: Set to the size of the contents in bytes.
+bool LevelPack::read(std::string name, const char *&data, size_t &size) {
+    std::map<std::string, int>::iterator found = entry_ids.find(name);
+    if (found == entry_ids.end()) {
+        return false;
+    }
+
+    int id = found->second;
+    LevelPackEntry &entry = entries[id];
+    if (stale[id]) {
+        return false;
+    }
+    if (!checked[id]) {
+        if (is_loose_file_newer(entry.name)) {
+            stale[id] = true;
+            return false;
+        }
+        if (level_image_checksum(file.data() + entry.offset, entry.size) != entry.checksum) {
+            return false;
+        }
+        checked[id] = true;
+    }
+    data = file.data() + entry.offset;
+    size = entry.size;
+    return true;
+}
+
+// Returns if the loose file of an entry has been changed since the pack was built. The times are compared to the
+// nanosecond, and a tie counts as changed. A loose file that does not exist has not been changed, so that a pack
+// can be shipped without them.
+// name: The name of the entry, e.g. "data/default.bl".
+bool LevelPack::is_loose_file_newer(const char *name) {
+    struct stat info;
+    if (stat(name, &info) != 0) {
+        return false;
+    }
+    if (info.st_mtim.tv_sec != pack_info.st_mtim.tv_sec) {
+        return info.st_mtim.tv_sec > pack_info.st_mtim.tv_sec;
+    }
+    return info.st_mtim.tv_nsec >= pack_info.st_mtim.tv_nsec;
+}
+
+// Writes a level pack. Returns true if the pack is written successfully.
+// filename: The address of the pack to write.
+// items: The entries, with the levels in the order they are played. Every name must be shorter than 56 characters.
+bool LevelPack::write(std::string filename, std::vector<LevelPackItem> &items) {
+    LevelPackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, level_pack_magic, sizeof(header.magic));
+    header.version = level_pack_version;
+    header.byte_order = level_image_byte_order;
+    header.entry_count = items.size();
+
+    std::vector<LevelPackEntry> toc(items.size());
+    uint64_t offset = sizeof(header) + toc.size() * sizeof(LevelPackEntry);
+    for (size_t i = 0; i < items.size(); i++) {
+        if (items[i].name.size() >= sizeof(toc[i].name)) {
+            return false;
+        }
+        std::memset(&toc[i], 0, sizeof(toc[i]));
+        std::strncpy(toc[i].name, items[i].name.c_str(), sizeof(toc[i].name));
+        toc[i].kind = items[i].kind;
+        toc[i].checksum = level_image_checksum(items[i].contents.data(), items[i].contents.size());
+        toc[i].offset = offset;
+        toc[i].size = items[i].contents.size();
+        offset += (items[i].contents.size() + 7) / 8 * 8;
+    }
+    header.size = offset;
+    header.toc_checksum = level_image_checksum((const char *)toc.data(), toc.size() * sizeof(LevelPackEntry));
+
+    std::ofstream fout(filename, std::ios::binary);
+    fout.write((const char *)&header, sizeof(header));
+    fout.write((const char *)toc.data(), toc.size() * sizeof(LevelPackEntry));
+    const char padding[8] = {0};
+    for (LevelPackItem &item : items) {
+        fout.write(item.contents.data(), item.contents.size());
+        fout.write(padding, (8 - item.contents.size() % 8) % 8);
+    }
+    fout.close();
+    return !fout.fail();
+}
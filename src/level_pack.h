@@ -0,0 +1,86 @@
+#include "mapped_file.h"
+
+#include <sys/stat.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef LEVEL_PACK_H_
+#define LEVEL_PACK_H_
+
+// A level pack (.pack file) holds a whole campaign in one file: every level, compiled (see level_image.h),
+// in the order they are played, and the text files the menus show, such as the instruction pages.
+// Each entry is named by the address its loose file had, e.g. "data/default.bl" or "data/instructions0.txt",
+// so that anything looked up by file name can be found in the pack instead.
+//
+// Layout, in the byte order of the machine that built it:
+// LevelPackHeader, then entry_count LevelPackEntry (the table of contents), then the entries' contents,
+// each starting at a multiple of 8 bytes.
+
+const char level_pack_magic[4] = {'B', 'P', 'K', '\n'};
+// Increase this whenever the layout changes. Packs of other versions are rejected.
+const uint32_t level_pack_version = 1;
+
+struct LevelPackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t entry_count;
+    // The size of the whole pack in bytes.
+    uint64_t size;
+    // Checksum of the table of contents.
+    uint32_t toc_checksum;
+    uint32_t reserved;
+};
+
+struct LevelPackEntry {
+    // The name of the entry, padded with '\0'. Names must be shorter than this.
+    char name[56];
+    uint32_t kind;
+    // Checksum of the contents, checked when the entry is first read.
+    uint32_t checksum;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// An entry to be written to a level pack.
+struct LevelPackItem {
+    std::string name;
+    int kind;
+    std::vector<char> contents;
+};
+
+class LevelPack {
+    public:
+        // The kinds of entries.
+        enum Kind { LEVEL = 1, TEXT = 2 };
+
+        bool open(std::string filename);
+        bool is_open();
+
+        std::vector<std::string> get_level_names();
+        bool has(std::string name);
+        bool read(std::string name, const char *&data, size_t &size);
+
+        static bool write(std::string filename, std::vector<LevelPackItem> &items);
+
+    private:
+        // The pack stays mapped until the LevelPack is destroyed, so entries are read without copying.
+        MappedFile file;
+        // The status of the pack file when it was opened, to tell when it was built.
+        struct stat pack_info;
+        std::vector<LevelPackEntry> entries;
+        // Index into entries for each name.
+        std::map<std::string, int> entry_ids;
+        // Whether each entry's checksum has been checked and found to match.
+        std::vector<bool> checked;
+        // Whether each entry's loose file has been found to be newer than the pack.
+        std::vector<bool> stale;
+
+        bool is_loose_file_newer(const char *name);
+};
+
+#endif
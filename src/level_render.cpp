@@ -0,0 +1,244 @@
+#include "level.h"
+#include "ball.h"
+#include "game_stat.h"
+#include "missile.h"
+#include "ncu.h"
+#include "playing_field.h"
+#include "power_up_drop.h"
+#include "rect_wall.h"
+#include "render_target.h"
+
+#include <vector>
+
+// Drawing the Level on the screen.
+// The bricks and the well rarely change, so only the first frame (and the first frame after the pause menu)
+// draws the whole playing field. After that, each frame clears the cells that entities were drawn on in the last
+// frame and the cells of removed bricks, draws again whatever was underneath them, and then draws the entities
+// at their new positions. Everything is drawn through the playing field's render target; for the
+// display window, ncurses only sends the cells that actually changed to the terminal.
+//
+// The blank background, the walls of the well and the unbreakable bricks never change during a level, so they are
+// drawn once into the static layer. Clearing a block of cells copies the static layer into it instead, which
+// costs the same however many walls there are; only the breakable bricks and the shield are drawn on top.
+
+// Displays everything inside the Level to the main screen (PlayingField).
+void Level::render_screen() {
+    PlayingField &pf = *pf_ptr;
+
+    // Bricks are drawn differently with reduced detail
+    if (pf.is_reduced_detail() != drawn_reduced_detail) {
+        full_redraw = true;
+    }
+    if (full_redraw) {
+        render_all(pf);
+    } else {
+        render_changes(pf);
+    }
+    render_entities(pf);
+
+    pf.get_render_target().present();
+}
+
+// Draws the blank background, the walls of the well and the unbreakable bricks into the static layer.
+// The walls of the well are drawn after every brick, so they are always in the layer. An unbreakable brick is left out
+// (and drawn with the breakable bricks) if a brick drawn after it that is not in the layer overlaps it, so that
+// whatever is in the layer is always drawn over the bricks that are not.
+// pf: The playing field that the layer is for.
+void Level::render_static_layer(PlayingField &pf) {
+    int slots = bricks.slot_count();
+    brick_ranges.resize(slots);
+    for (int id = 0; id < slots; id++) {
+        if (bricks.exists(id)) {
+            CellBox &box = brick_ranges[id];
+            RectWall(bricks.get_rect(id)).get_drawing_range(pf, box.r1, box.r2, box.c1, box.c2);
+        }
+    }
+
+    // Only the bricks near each unbreakable brick are checked for overlaps, using the grids
+    static_bricks.assign(slots, 0);
+    drawn_brick_grid.clear();
+    for (int id = slots - 1; id >= 0; id--) {
+        if (!bricks.exists(id)) {
+            continue;
+        }
+        if (bricks.is_unbreakable(id)) {
+            static_bricks[id] = 1;
+            brick_grid.query(pf.get_cell_area(brick_ranges[id]), nearby_bricks);
+            for (int later : nearby_bricks) {
+                if (later > id && !static_bricks[later] && brick_ranges[id].intersects(brick_ranges[later])) {
+                    static_bricks[id] = 0;
+                    break;
+                }
+            }
+        }
+        if (!static_bricks[id]) {
+            drawn_brick_grid.insert(id, bricks.get_rect(id));
+        }
+    }
+
+    static_overlaps.clear();
+    for (int id = 0; id < slots; id++) {
+        if (bricks.exists(id) && static_bricks[id]) {
+            add_static_overlaps(pf, brick_ranges[id]);
+        }
+    }
+    for (RectWall wall : well.get_walls()) {
+        CellBox box;
+        wall.get_drawing_range(pf, box.r1, box.r2, box.c1, box.c2);
+        add_static_overlaps(pf, box);
+    }
+
+    RenderTarget &target = pf.get_render_target();
+    pf.set_render_target(static_layer);
+    static_layer.clear();
+    for (int id = 0; id < slots; id++) {
+        if (bricks.exists(id) && static_bricks[id]) {
+            bricks.draw_brick(id, pf);
+        }
+    }
+    well.draw_walls(pf);
+    pf.set_render_target(target);
+
+    static_layer_stale = false;
+}
+
+// Adds the cells where a brick outside the static layer lies under a wall or brick in it to static_overlaps.
+// pf: The playing field that the layer is for.
+// static_range: The cells of the wall or brick in the layer.
+void Level::add_static_overlaps(PlayingField &pf, CellBox static_range) {
+    drawn_brick_grid.query(pf.get_cell_area(static_range), nearby_bricks);
+    for (int id : nearby_bricks) {
+        if (static_range.intersects(brick_ranges[id])) {
+            static_overlaps.push_back(static_range.intersection(brick_ranges[id]));
+        }
+    }
+}
+
+// Draws the playing field and the game stats from scratch.
+// pf: The playing field to draw on.
+void Level::render_all(PlayingField &pf) {
+    if (static_layer_stale) {
+        render_static_layer(pf);
+    }
+
+    game_stat_ptr->draw_display_window();
+
+    RenderTarget &target = pf.get_render_target();
+    static_layer.copy_to(target, 0, pf.max_y - 1, 0, pf.max_x - 1);
+    for (int id = 0; id < bricks.slot_count(); id++) {
+        if (bricks.exists(id) && !static_bricks[id]) {
+            bricks.draw_brick(id, pf);
+        }
+    }
+    for (CellBox overlap : static_overlaps) {
+        static_layer.copy_to(target, overlap.r1, overlap.r2, overlap.c1, overlap.c2);
+    }
+    well.draw_shield(pf);
+    drawn_shield_level = well.shield.get_level();
+    drawn_reduced_detail = pf.is_reduced_detail();
+
+    // Everything was drawn again, so there is nothing left to clear.
+    drawn_boxes.clear();
+    removed_bricks.clear();
+    full_redraw = false;
+}
+
+// Clears the cells that may have changed since the last frame and draws what lies underneath them again.
+// pf: The playing field to draw on.
+void Level::render_changes(PlayingField &pf) {
+    if (static_layer_stale) {
+        render_static_layer(pf);
+    }
+
+    game_stat_ptr->update_display_window();
+
+    dirty_boxes.assign(drawn_boxes.begin(), drawn_boxes.end());
+    for (Rect rect : removed_bricks) {
+        CellBox box;
+        RectWall(rect).get_drawing_range(pf, box.r1, box.r2, box.c1, box.c2);
+        dirty_boxes.push_back(box);
+    }
+    removed_bricks.clear();
+    if (pf.is_reduced_detail()) {
+        merge_dirty_boxes();
+    }
+
+    // The shield is drawn as a whole when it changes
+    if (well.shield.get_level() != drawn_shield_level) {
+        well.draw_shield(pf);
+        drawn_shield_level = well.shield.get_level();
+    }
+
+    // Clear each box to the static layer, then draw the bricks that are not in the layer and the shield inside it
+    // in the same order as render_all(), so that overlapping bricks come out the same.
+    RenderTarget &target = pf.get_render_target();
+    for (CellBox box : dirty_boxes) {
+        if (box.is_empty()) {
+            continue;
+        }
+        static_layer.copy_to(target, box.r1, box.r2, box.c1, box.c2);
+
+        drawn_brick_grid.query(pf.get_cell_area(box), nearby_bricks);
+        for (int id : nearby_bricks) {
+            bricks.draw_brick(id, pf, box);
+        }
+        if (!nearby_bricks.empty()) {
+            for (CellBox overlap : static_overlaps) {
+                CellBox cells = overlap.intersection(box);
+                if (!cells.is_empty()) {
+                    static_layer.copy_to(target, cells.r1, cells.r2, cells.c1, cells.c2);
+                }
+            }
+        }
+        well.draw_shield(pf, box);
+    }
+}
+
+// Merges the boxes to clear that share cells into the boxes that cover them, so that fewer cells are cleared and
+// drawn again twice, e.g. where a ball was drawn over the paddle or another ball.
+// Covering a box may clear cells that did not change, which are drawn again as they were.
+void Level::merge_dirty_boxes() {
+    for (size_t i = 0; i < dirty_boxes.size(); i++) {
+        size_t j = i + 1;
+        while (j < dirty_boxes.size()) {
+            if (!dirty_boxes[i].intersects(dirty_boxes[j])) {
+                ++j;
+                continue;
+            }
+            // The merged box is bigger, so the boxes after it are checked again
+            dirty_boxes[i] = dirty_boxes[i].bounding_box(dirty_boxes[j]);
+            dirty_boxes[j] = dirty_boxes.back();
+            dirty_boxes.pop_back();
+            j = i + 1;
+        }
+    }
+}
+
+// Draws the paddle, missiles, power-ups and balls, and remembers the cells they were drawn on.
+// pf: The playing field to draw on.
+void Level::render_entities(PlayingField &pf) {
+    CellBox box;
+    drawn_boxes.clear();
+
+    paddle.get_drawing_range(pf, box.r1, box.r2, box.c1, box.c2);
+    drawn_boxes.push_back(box);
+    paddle.draw_pf(pf);
+
+    for (Missile *m : missiles) {
+        m->get_drawing_range(pf, box.r1, box.r2, box.c1, box.c2);
+        drawn_boxes.push_back(box);
+        m->draw_pf(pf);
+    }
+
+    for (PowerUpDrop *p : power_up_drops) {
+        p->get_drawing_range(pf, box.r1, box.r2, box.c1, box.c2);
+        drawn_boxes.push_back(box);
+        p->draw_pf(pf);
+    }
+
+    for (Ball *ball : balls) {
+        ball->get_drawing_range(pf, box.r1, box.r2, box.c1, box.c2);
+        drawn_boxes.push_back(box);
+        ball->draw_pf(pf);
+    }
+}
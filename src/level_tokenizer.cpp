@@ -0,0 +1,139 @@
+#include "level_tokenizer.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// Returns if the token is exactly a word.
+// word: The word to compare with.
+bool LevelToken::is(const char *word) const {
+    return std::strlen(word) == length && std::memcmp(text, word, length) == 0;
+}
+
+// Returns a copy of the token, e.g. to show in an error.
+std::string LevelToken::str() const {
+    return std::string(text, length);
+}
+
+// Constructs a tokenizer that reads from the start of some contents.
+// data: The contents of the .bl file. They must outlive the tokenizer and its tokens, and need not end with '\0'.
+// size: The size of the contents in bytes.
+// source: The name of the file, shown in errors.
+LevelTokenizer::LevelTokenizer(const char *data, size_t size, std::string source) {
+    cur = data;
+    end = data + size;
+    LevelTokenizer::source = source;
+}
+
+// Skips whitespace and comments, keeping track of the line and column.
+// A comment starts with "//" and runs to the end of the line.
+void LevelTokenizer::skip_space() {
+    while (cur < end) {
+        if (*cur == '\n') {
+            ++line;
+            column = 1;
+        } else if (*cur == ' ' || *cur == '\t' || *cur == '\r') {
+            ++column;
+        } else if (*cur == '/' && cur + 1 < end && cur[1] == '/') {
+            while (cur < end && *cur != '\n') {
+                ++cur;
+            }
+            continue;
+        } else {
+            return;
+        }
+        ++cur;
+    }
+}
+
+// Returns if there are no more words.
+bool LevelTokenizer::at_end() {
+    skip_space();
+    return cur == end;
+}
+
+// Reads the next word. Throws a runtime error if there is none.
+// expected: What the word should be, shown in the error.
+LevelToken LevelTokenizer::next(const char *expected) {
+    skip_space();
+    LevelToken token = {cur, 0, line, column};
+    if (cur == end) {
+        throw error(token, std::string("expected ") + expected + ", but the file ended");
+    }
+    while (cur < end && *cur != ' ' && *cur != '\t' && *cur != '\n' && *cur != '\r') {
+        ++cur;
+    }
+    token.length = cur - token.text;
+    column += token.length;
+    return token;
+}
+
+// Reads the next word as a number, e.g. "-13.0". Throws a runtime error if it is not one.
+// what: What the number is for, shown in the error.
+double LevelTokenizer::next_double(const char *what) {
+    return to_double(next(what), what);
+}
+
+// Reads the next word as a whole number, e.g. "13". Throws a runtime error if it is not one.
+// what: What the number is for, shown in the error.
+int LevelTokenizer::next_int(const char *what) {
+    return to_int(next(what), what);
+}
+
+// Returns the number in a word, e.g. "-13.0". Throws a runtime error if it is not one.
+// token: The word.
+// what: What the number is for, shown in the error.
+double LevelTokenizer::to_double(const LevelToken &token, const char *what) {
+    // strtod needs a '\0' at the end, which the contents may not have
+    char buffer[64];
+    if (token.length >= sizeof(buffer)) {
+        throw error(token, std::string("expected a number for ") + what + ", got \"" + token.str() + "\"");
+    }
+    std::memcpy(buffer, token.text, token.length);
+    buffer[token.length] = '\0';
+
+    char *parsed_end;
+    double value = std::strtod(buffer, &parsed_end);
+    if (parsed_end != buffer + token.length || !std::isfinite(value)) {
+        throw error(token, std::string("expected a number for ") + what + ", got \"" + token.str() + "\"");
+    }
+    return value;
+}
+
+// Returns the whole number in a word, e.g. "13". Throws a runtime error if it is not one.
+// token: The word.
+// what: What the number is for, shown in the error.
+int LevelTokenizer::to_int(const LevelToken &token, const char *what) {
+    size_t i = 0;
+    bool negative = false;
+    if (token.text[0] == '-' || token.text[0] == '+') {
+        negative = token.text[0] == '-';
+        i = 1;
+    }
+    if (i == token.length) {
+        throw error(token, std::string("expected a whole number for ") + what + ", got \"" + token.str() + "\"");
+    }
+
+    long long value = 0;
+    for (; i < token.length; i++) {
+        char c = token.text[i];
+        if (c < '0' || c > '9') {
+            throw error(token, std::string("expected a whole number for ") + what + ", got \"" + token.str() + "\"");
+        }
+        value = value * 10 + (c - '0');
+        if (value > INT_MAX) {
+            throw error(token, std::string("number for ") + what + " is too large");
+        }
+    }
+    return negative ? -value : value;
+}
+
+// Returns an error to throw, that says where in the file a token is.
+// token: The token the error is about.
+// message: What is wrong.
+std::runtime_error LevelTokenizer::error(const LevelToken &token, std::string message) {
+    return std::runtime_error(source + ":" + std::to_string(token.line) + ":" + std::to_string(token.column) + ": " + message);
+}
@@ -0,0 +1,45 @@
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#ifndef LEVEL_TOKENIZER_H_
+#define LEVEL_TOKENIZER_H_
+
+// A word in a .bl file. It points into the file's contents instead of copying them,
+// so it is only valid while the contents are.
+struct LevelToken {
+    const char *text;
+    size_t length;
+    // Where the word starts in the file, counting from 1.
+    int line, column;
+
+    bool is(const char *word) const;
+    std::string str() const;
+};
+
+// Splits the contents of a .bl file into whitespace-separated words, in place, and reads numbers from them.
+// Anything from "//" to the end of a line is a comment, and is skipped.
+// Every error names the file, line and column it was found at.
+class LevelTokenizer {
+    public:
+        LevelTokenizer(const char *data, size_t size, std::string source);
+
+        bool at_end();
+        LevelToken next(const char *expected);
+        double next_double(const char *what);
+        int next_int(const char *what);
+        double to_double(const LevelToken &token, const char *what);
+        int to_int(const LevelToken &token, const char *what);
+
+        std::runtime_error error(const LevelToken &token, std::string message);
+
+    private:
+        const char *cur, *end;
+        // The name of the file, shown in errors.
+        std::string source;
+        int line = 1, column = 1;
+
+        void skip_space();
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "input_reader.h"
+#include "level.h"
+#include "menu.h"
+#include "ncu.h"
+#include "notification_bar.h"
+#include "trace.h"
+
+// The parts of Level that talk to the player: reading keys from the terminal and the pause menu.
+// These are kept apart from level.cpp so that the simulation can be built without them (see "sim" in the makefile).
+
+// Before the player launches the ball, make the ball swing from left to right.
+// When the player presses Space, launch the ball.
+void Level::launch_ball() {
+    TraceSpan span("aim", "game");
+    int ch = 'a';
+    do {
+        // Wait for a frame
+        int ticks = frame_clock_ptr->wait_for_frame();
+
+        read_keys(ticks);
+        // Once the ball is launched, the ticks left over are not spent aiming
+        for (int i = 0; i < ticks && ch != ' '; i++) {
+            ch = frame_keys[i];
+            if (ch == 'p' || ch == 'P') {
+                if (pause_menu() == 0) {
+                    return;
+                }
+            }
+            aim_ball(ch);
+        }
+
+        render_screen();
+    } while (ch != ' ');
+}
+
+// Reads the keys for a frame into frame_keys, one for each tick (ERR if there is none).
+// With an InputReader bound, every key pressed since the last frame is used; otherwise a single key is read
+// from ncurses, and applies to the first tick only.
+// ticks: The number of ticks in the frame, as given by the FrameClock.
+void Level::read_keys(int ticks) {
+    if (input_ptr != NULL) {
+        input_ptr->read_frame(ticks, frame_keys);
+        return;
+    }
+    frame_keys.assign(ticks, ERR);
+    frame_keys[0] = wgetch(pf_ptr->get_display_window());
+}
+
+// Reads the keys from the player, simulates the game for a number of ticks and draws the result.
+// ticks: The number of ticks to simulate, as given by the FrameClock.
+void Level::run_loop(int ticks) {
+    {
+        ScopedPhase phase(profiler_ptr, FrameProfiler::INPUT);
+        read_keys(ticks);
+    }
+
+    for (int i = 0; i < ticks && (i == 0 || (has_ball() && !all_bricks_destroyed())); i++) {
+        int ch = frame_keys[i];
+        if (ch == 'p' || ch == 'P') {
+            pause_menu();
+        }
+        if ((ch == 'f' || ch == 'F') && profiler_ptr != NULL) {
+            profiler_ptr->toggle_overlay();
+            game_stat_ptr->draw_display_window();
+        }
+        simulate_frame(ch);
+    }
+
+    // With reduced detail, every other frame is left undrawn, and the next one draws what changed in both
+    render_skipped = pf_ptr->is_reduced_detail() && !render_skipped;
+    if (render_skipped) {
+        return;
+    }
+    ScopedPhase phase(profiler_ptr, FrameProfiler::RENDER);
+    render_screen();
+}
+
+// Pauses the game and opens up the pause menu.
+// Returns the option that the player chose (0 = exit game, 1 = resume).
+int Level::pause_menu() {
+    Menu sample;
+
+    pf_ptr->get_render_target().release();
+
+    // The menu reads its keys through ncurses
+    if (input_ptr != NULL) {
+        input_ptr->suspend();
+    }
+    int choice;
+    {
+        TraceSpan span("pause menu", "ui");
+        choice = sample.run_pause_ui();
+    }
+    if (input_ptr != NULL) {
+        input_ptr->resume();
+    }
+
+    // Time spent in the menu should not be made up for when the game resumes.
+    frame_clock_ptr->start();
+
+    // The menu was drawn over the playing field.
+    full_redraw = true;
+
+    if (choice == 0) {
+        set_quit_status(true);
+    }
+    return choice;
+}
@@ -0,0 +1,191 @@
+#include "link_monitor.h"
+#include "input_reader.h"
+#include "trace.h"
+
+#include <sys/ioctl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+const int LinkMonitor::max_queued_bytes;
+const int LinkMonitor::max_round_trip_ms;
+const int LinkMonitor::slow_frames_to_reduce;
+const int LinkMonitor::fast_frames_to_restore;
+const int LinkMonitor::probe_period;
+const int LinkMonitor::probe_timeout_ms;
+const int LinkMonitor::first_answer_timeout_ms;
+
+// Constructs a link to the terminal that the game writes to.
+// out: Where the terminal's output goes, e.g. stdout. Position requests are written to it as well.
+TerminalLink::TerminalLink(FILE *out) {
+    TerminalLink::out = out;
+}
+
+// Connects the InputReader that reads the answers to position requests. Without one, no requests are sent,
+// as the answers would be read by ncurses as keys.
+// input: The InputReader to connect to.
+void TerminalLink::bind_input_reader(InputReader &input) {
+    input_ptr = &input;
+}
+
+// Returns the current time.
+std::chrono::steady_clock::time_point TerminalLink::now() {
+    return std::chrono::steady_clock::now();
+}
+
+// Returns the bytes written to the terminal that it has not taken yet.
+// It is 0 if the output is not a terminal that can tell.
+int TerminalLink::get_queued_bytes() {
+    int queued = 0;
+    if (ioctl(fileno(out), TIOCOUTQ, &queued) != 0) {
+        return 0;
+    }
+    return queued;
+}
+
+// Returns if an InputReader reads the answers to position requests.
+bool TerminalLink::can_probe() {
+    return input_ptr != NULL;
+}
+
+// Sends a cursor position request to the terminal. Only called if can_probe() is true.
+void TerminalLink::send_probe() {
+    input_ptr->expect_position_report();
+    std::fputs("\033[6n", out);
+    std::fflush(out);
+}
+
+// Returns the number of answers to position requests read so far.
+long long TerminalLink::get_position_reports() {
+    return input_ptr->get_position_reports();
+}
+
+// Returns when the last answer to a position request was read.
+std::chrono::steady_clock::time_point TerminalLink::get_last_report_time() {
+    return input_ptr->get_last_report_time();
+}
+
+// Returns the number of times the InputReader has been suspended.
+long long TerminalLink::get_suspensions() {
+    return input_ptr->get_suspensions();
+}
+
+// Constructs a monitor of a terminal.
+// source: Where to learn how the terminal is keeping up. It must outlive the monitor.
+LinkMonitor::LinkMonitor(LinkSource &source) {
+    source_ptr = &source;
+}
+
+// Starts watching from full detail, e.g. at the start of a game. A terminal that did not answer position
+// requests in the last game is asked again.
+void LinkMonitor::reset() {
+    reduced = false;
+    slow_frames = fast_frames = 0;
+    queued_bytes = 0;
+    round_trip_ms = 0;
+    probing = false;
+    answered_once = false;
+    probes_enabled = true;
+    frames_since_probe = 0;
+    frame_count = reduced_frame_count = 0;
+}
+
+// Checks how the terminal is keeping up once a frame has been sent, and reduces or restores the detail.
+void LinkMonitor::end_frame() {
+    queued_bytes = source_ptr->get_queued_bytes();
+    update_probe();
+
+    bool slow = queued_bytes > max_queued_bytes || round_trip_ms > max_round_trip_ms;
+    if (slow) {
+        ++slow_frames;
+        fast_frames = 0;
+    } else {
+        ++fast_frames;
+        slow_frames = 0;
+    }
+
+    if (!reduced && slow_frames >= slow_frames_to_reduce) {
+        reduced = true;
+        trace_instant("detail reduced", "render", "queued bytes", queued_bytes);
+    } else if (reduced && fast_frames >= fast_frames_to_restore) {
+        reduced = false;
+        trace_instant("detail restored", "render", "queued bytes", queued_bytes);
+    }
+
+    ++frame_count;
+    if (reduced) {
+        ++reduced_frame_count;
+    }
+}
+
+// Sends a position request every probe_period frames, and measures the time until it is answered.
+void LinkMonitor::update_probe() {
+    if (!probes_enabled || !source_ptr->can_probe()) {
+        return;
+    }
+    std::chrono::steady_clock::time_point now = source_ptr->now();
+
+    if (probing) {
+        if (source_ptr->get_position_reports() > reports_before_probe) {
+            // A late answer to an earlier request can be taken for this one, so it is never below 0
+            round_trip_ms = std::max(0.0, std::chrono::duration<double, std::milli>(
+                                              source_ptr->get_last_report_time() - probe_time).count());
+            answered_once = true;
+            end_probe();
+        } else if (source_ptr->get_suspensions() != probe_suspensions) {
+            // The answer may have been thrown away, and the time spent suspended is not the terminal's
+            end_probe();
+        } else if (!answered_once && now - probe_time > std::chrono::milliseconds(first_answer_timeout_ms)) {
+            // A terminal that has never answered probably cannot, so it is not asked again this game
+            probes_enabled = false;
+            end_probe();
+        } else if (answered_once && now - probe_time > std::chrono::milliseconds(probe_timeout_ms)) {
+            // The answer is very late or was lost. Either way the link is slow for now, and the next request
+            // finds out whether it still is
+            round_trip_ms = probe_timeout_ms;
+            end_probe();
+        }
+        return;
+    }
+
+    if (++frames_since_probe < probe_period) {
+        return;
+    }
+    reports_before_probe = source_ptr->get_position_reports();
+    source_ptr->send_probe();
+    probe_suspensions = source_ptr->get_suspensions();
+    probe_time = now;
+    probing = true;
+}
+
+// Stops waiting for the answer to the last position request, and starts counting the frames to the next one.
+void LinkMonitor::end_probe() {
+    probing = false;
+    frames_since_probe = 0;
+}
+
+// Returns if the playing field should be drawn with reduced detail.
+bool LinkMonitor::is_reduced() {
+    return reduced;
+}
+
+// Returns the bytes that were waiting to be sent to the terminal after the last frame.
+int LinkMonitor::get_queued_bytes() {
+    return queued_bytes;
+}
+
+// Returns the time the terminal last took to answer a position request, in milliseconds.
+double LinkMonitor::get_round_trip_ms() {
+    return round_trip_ms;
+}
+
+// Returns the number of frames watched since the last reset().
+long long LinkMonitor::get_frame_count() {
+    return frame_count;
+}
+
+// Returns the number of frames drawn with reduced detail since the last reset().
+long long LinkMonitor::get_reduced_frame_count() {
+    return reduced_frame_count;
+}
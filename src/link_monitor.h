@@ -0,0 +1,117 @@
+#include "input_reader.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+#ifndef LINK_MONITOR_H_
+#define LINK_MONITOR_H_
+
+// Where a LinkMonitor learns how the terminal is keeping up. The game asks the terminal itself (TerminalLink);
+// the link monitor check plays back a made-up terminal, with its own clock, instead.
+class LinkSource {
+    public:
+        virtual ~LinkSource() {}
+
+        // Returns the current time.
+        virtual std::chrono::steady_clock::time_point now() = 0;
+
+        // Returns the bytes written to the terminal that it has not taken yet, or 0 if it cannot tell.
+        virtual int get_queued_bytes() = 0;
+
+        // Returns if position requests can be sent, i.e. if something reads their answers.
+        virtual bool can_probe() = 0;
+
+        // Sends a cursor position request.
+        virtual void send_probe() = 0;
+
+        // Returns the number of answers to position requests read so far.
+        virtual long long get_position_reports() = 0;
+
+        // Returns when the last answer to a position request was read.
+        virtual std::chrono::steady_clock::time_point get_last_report_time() = 0;
+
+        // Returns the number of times the reader of the answers has been suspended, e.g. for the pause menu.
+        // An answer on its way at the time may be thrown away or read as keys by ncurses.
+        virtual long long get_suspensions() = 0;
+};
+
+// The terminal that the game writes to. The answers to position requests are read by an InputReader.
+class TerminalLink : public LinkSource {
+    public:
+        TerminalLink(FILE *out);
+
+        void bind_input_reader(InputReader &input);
+
+        std::chrono::steady_clock::time_point now();
+        int get_queued_bytes();
+        bool can_probe();
+        void send_probe();
+        long long get_position_reports();
+        std::chrono::steady_clock::time_point get_last_report_time();
+        long long get_suspensions();
+
+    private:
+        FILE *out;
+        InputReader *input_ptr = NULL;
+};
+
+// Watches whether the terminal keeps up with the frames sent to it, e.g. over a slow serial line or SSH over a
+// poor connection, and tells the game when to draw with reduced detail (see PlayingField::set_reduced_detail()).
+//
+// Two signs are watched after every frame:
+// - The bytes written to the terminal that it has not taken yet (TIOCOUTQ). These pile up when the link is
+//   slower than the frames.
+// - The time the terminal takes to answer a cursor position request (ESC [ 6 n), sent about once a second.
+//   The answer comes after everything sent before the request has been shown, so it also catches delays that
+//   happen after the output queue, e.g. in SSH. A request still waiting for its answer does not count; one not
+//   answered in probe_timeout_ms is given up on, and counts as a round trip of that long.
+// The detail is reduced after a few slow frames in a row, and restored only after a long run of fast ones,
+// so that it does not switch back and forth.
+class LinkMonitor {
+    public:
+        LinkMonitor(LinkSource &source);
+
+        void reset();
+        void end_frame();
+
+        bool is_reduced();
+        int get_queued_bytes();
+        double get_round_trip_ms();
+        long long get_frame_count();
+        long long get_reduced_frame_count();
+
+        // Bytes waiting to be sent to the terminal, and the time to answer a position request, above which
+        // a frame counts as slow.
+        static const int max_queued_bytes = 1024;
+        static const int max_round_trip_ms = 250;
+        // Slow frames in a row before the detail is reduced, and fast frames in a row before it is restored.
+        static const int slow_frames_to_reduce = 5;
+        static const int fast_frames_to_restore = 150;
+        // Frames between position requests, how long to wait for an answer before giving up on it, and how long
+        // to wait for the first answer before deciding that the terminal does not answer them at all.
+        static const int probe_period = 30;
+        static const int probe_timeout_ms = 2000;
+        static const int first_answer_timeout_ms = 5000;
+
+    private:
+        LinkSource *source_ptr;
+
+        bool reduced = false;
+        int slow_frames = 0, fast_frames = 0;
+        int queued_bytes = 0;
+        double round_trip_ms = 0;
+
+        // The position request waiting for an answer, if any.
+        bool probing = false, answered_once = false, probes_enabled = true;
+        long long reports_before_probe = 0, probe_suspensions = 0;
+        int frames_since_probe = 0;
+        std::chrono::steady_clock::time_point probe_time;
+
+        long long frame_count = 0, reduced_frame_count = 0;
+
+        void update_probe();
+        void end_probe();
+};
+
+#endif
@@ -0,0 +1,255 @@
+#include "link_monitor.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks when a LinkMonitor reduces and restores the detail, by playing back made-up terminals frame by frame:
+// one that keeps up, one whose output queue fills, one that answers position requests slowly, one that never
+// answers them, one that loses an answer, and one whose reader is suspended while a request waits.
+// Time only passes when a frame does, so the results do not depend on how fast the check runs.
+// Exits with 1 if any case goes wrong.
+
+// A made-up terminal, with its own clock.
+class FakeLink : public LinkSource {
+    public:
+        // The bytes waiting to be sent after every frame.
+        int queued = 0;
+        // How long the terminal takes to answer a position request, or -1 if it does not answer.
+        int answer_ms = 20;
+        // Position requests sent so far.
+        int probes_sent = 0;
+
+        // Lets time pass, and reads the answers that arrived meanwhile.
+        // ms: The time to pass, in milliseconds.
+        void advance(int ms) {
+            time += std::chrono::milliseconds(ms);
+            while (!answers.empty() && answers.front() <= time) {
+                last_report = answers.front();
+                answers.erase(answers.begin());
+                ++reports_read;
+            }
+        }
+
+        // Suspends the reader, as the pause menu does. Answers on their way are given up on and never read.
+        void suspend() {
+            answers.clear();
+            ++suspensions;
+        }
+
+        std::chrono::steady_clock::time_point now() {
+            return time;
+        }
+
+        int get_queued_bytes() {
+            return queued;
+        }
+
+        bool can_probe() {
+            return true;
+        }
+
+        void send_probe() {
+            ++probes_sent;
+            if (answer_ms >= 0) {
+                answers.push_back(time + std::chrono::milliseconds(answer_ms));
+            }
+        }
+
+        long long get_position_reports() {
+            return reports_read;
+        }
+
+        std::chrono::steady_clock::time_point get_last_report_time() {
+            return last_report;
+        }
+
+        long long get_suspensions() {
+            return suspensions;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point time = std::chrono::steady_clock::time_point() + std::chrono::hours(1);
+        std::chrono::steady_clock::time_point last_report;
+        std::vector<std::chrono::steady_clock::time_point> answers;
+        long long reports_read = 0, suspensions = 0;
+};
+
+// The time between frames in the game, in milliseconds.
+const int frame_ms = 33;
+
+// Plays a number of frames, and counts the frames drawn with reduced detail.
+// link: The made-up terminal.
+// monitor: The monitor watching it.
+// frames: The number of frames to play.
+// Returns the number of frames after which the detail was reduced.
+int play(FakeLink &link, LinkMonitor &monitor, int frames) {
+    int reduced = 0;
+    for (int i = 0; i < frames; i++) {
+        link.advance(frame_ms);
+        monitor.end_frame();
+        if (monitor.is_reduced()) {
+            ++reduced;
+        }
+    }
+    return reduced;
+}
+
+// A terminal that keeps up is never drawn with reduced detail, and its round trip is measured.
+std::string check_fast_link() {
+    FakeLink link;
+    LinkMonitor monitor(link);
+    monitor.reset();
+    if (play(link, monitor, 3000) > 0) {
+        return "reduced the detail";
+    }
+    if (link.probes_sent < 3000 / (LinkMonitor::probe_period + 1)) {
+        return "sent " + std::to_string(link.probes_sent) + " position requests";
+    }
+    if (monitor.get_round_trip_ms() != link.answer_ms) {
+        return "measured a round trip of " + std::to_string(monitor.get_round_trip_ms()) + " ms";
+    }
+    return "";
+}
+
+// The detail is reduced after slow_frames_to_reduce frames with a full output queue, and restored only after
+// fast_frames_to_restore frames without.
+std::string check_queue_hysteresis() {
+    FakeLink link;
+    LinkMonitor monitor(link);
+    monitor.reset();
+    link.queued = LinkMonitor::max_queued_bytes + 1;
+    if (play(link, monitor, LinkMonitor::slow_frames_to_reduce - 1) > 0) {
+        return "reduced the detail too early";
+    }
+    if (play(link, monitor, 1) != 1) {
+        return "did not reduce the detail";
+    }
+    // A single fast frame among slow ones changes nothing
+    link.queued = 0;
+    play(link, monitor, 1);
+    link.queued = LinkMonitor::max_queued_bytes + 1;
+    play(link, monitor, 1);
+    link.queued = 0;
+    if (play(link, monitor, LinkMonitor::fast_frames_to_restore - 1) != LinkMonitor::fast_frames_to_restore - 1) {
+        return "restored the detail too early";
+    }
+    if (play(link, monitor, 1) != 0) {
+        return "did not restore the detail";
+    }
+    return "";
+}
+
+// A slow answer reduces the detail once it arrives, but not while it is still on its way, and a fast answer
+// later restores it.
+std::string check_slow_round_trip() {
+    FakeLink link;
+    LinkMonitor monitor(link);
+    monitor.reset();
+    link.answer_ms = 400;
+    // The first request is sent after probe_period frames, and answered 400 ms (13 frames) later
+    if (play(link, monitor, LinkMonitor::probe_period + 10) > 0) {
+        return "counted an unanswered request as slow";
+    }
+    if (play(link, monitor, 20) == 0) {
+        return "did not reduce the detail";
+    }
+    link.answer_ms = 20;
+    int frames = 2 * LinkMonitor::probe_period + LinkMonitor::fast_frames_to_restore + 20;
+    play(link, monitor, frames);
+    if (monitor.is_reduced()) {
+        return "did not restore the detail";
+    }
+    return "";
+}
+
+// A terminal that never answers is asked once a game, and is not taken for a slow one.
+std::string check_silent_terminal() {
+    FakeLink link;
+    LinkMonitor monitor(link);
+    monitor.reset();
+    link.answer_ms = -1;
+    if (play(link, monitor, 1000) > 0) {
+        return "reduced the detail";
+    }
+    if (link.probes_sent != 1) {
+        return "sent " + std::to_string(link.probes_sent) + " position requests";
+    }
+    monitor.reset();
+    play(link, monitor, LinkMonitor::probe_period);
+    if (link.probes_sent != 2) {
+        return "did not ask again in a new game";
+    }
+    return "";
+}
+
+// A lost answer is given up on after probe_timeout_ms, so the detail is not reduced for the rest of the game.
+std::string check_lost_answer() {
+    FakeLink link;
+    LinkMonitor monitor(link);
+    monitor.reset();
+    play(link, monitor, 100);
+    link.answer_ms = -1;
+    int sent = link.probes_sent;
+    while (link.probes_sent == sent) {
+        play(link, monitor, 1);
+    }
+    link.answer_ms = 20;
+    if (play(link, monitor, LinkMonitor::probe_timeout_ms / frame_ms) > 0) {
+        return "counted the request as slow before it timed out";
+    }
+    int frames = LinkMonitor::probe_timeout_ms / frame_ms + 2 * LinkMonitor::probe_period +
+                 LinkMonitor::fast_frames_to_restore + 20;
+    play(link, monitor, frames);
+    if (monitor.is_reduced()) {
+        return "kept the detail reduced";
+    }
+    if (link.probes_sent < sent + 3 || monitor.get_round_trip_ms() != link.answer_ms) {
+        return "did not measure the round trip again";
+    }
+    return "";
+}
+
+// A request waiting while the reader is suspended is given up on at once, and the time spent suspended is not
+// counted as a round trip.
+std::string check_suspension() {
+    FakeLink link;
+    LinkMonitor monitor(link);
+    monitor.reset();
+    play(link, monitor, LinkMonitor::probe_period);
+    link.suspend();
+    // The pause menu is open for 10 s
+    link.advance(10000);
+    if (play(link, monitor, 300) > 0) {
+        return "reduced the detail";
+    }
+    if (link.probes_sent < 2 || monitor.get_round_trip_ms() != link.answer_ms) {
+        return "did not measure the round trip again";
+    }
+    return "";
+}
+
+// Runs every case.
+int main() {
+    struct Case {
+        std::string name;
+        std::string (*check)();
+    };
+    std::vector<Case> cases = {
+        {"fast link", check_fast_link},
+        {"queue hysteresis", check_queue_hysteresis},
+        {"slow round trip", check_slow_round_trip},
+        {"silent terminal", check_silent_terminal},
+        {"lost answer", check_lost_answer},
+        {"suspension", check_suspension}};
+
+    bool passed = true;
+    for (Case &c : cases) {
+        std::string error = c.check();
+        std::cout << c.name << ": " << (error == "" ? "ok" : error) << std::endl;
+        passed = passed && error == "";
+    }
+    std::cout << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -2,9 +2,9 @@
 #include "power_up.h"
 #include "power_up_list.h"
 
-#include <cmath>
 #include <random>
 #include <stdexcept>
+#include <vector>
 
 // Constructs a default loot table, used for randomizing power-ups.
 LootTable::LootTable() {
@@ -29,40 +29,93 @@ LootTable::LootTable(std::map<PowerUp, int> loot_table) {
     init(loot_table);
 }
 
-// Initializes the loot table by setting RNG and calculating the total weight.
+// Initializes the loot table by checking the weights and building the alias table.
+// Every column of the alias table holds total_weight units of probability: its own power-up's share, and the rest
+// taken from a power-up with more than one column's worth. The weights are whole numbers, so the table is exact.
+// The draws are the same every time until the table is given a seed.
 // loot_table: The power-up weights.
 void LootTable::init(std::map<PowerUp, int> loot_table) {
     LootTable::loot_table = loot_table;
-    engine = std::mt19937(rd());
 
     if (loot_table.size() == 0) {
         throw std::invalid_argument("Loot Table is empty");
     }
 
-    int sum = 0;
+    long long sum = 0;
     for (std::map<PowerUp, int>::iterator i = loot_table.begin(); i != loot_table.end(); i++) {
         int weight = (*i).second;
         if (weight <= 0) {
             throw std::invalid_argument("Weight should be positive");
         }
         sum += weight;
+        power_ups.push_back((*i).first);
     }
     total_weight = sum;
+
+    // Scale the weights so that an even share is total_weight, then pair columns with too little and too much
+    long long count = power_ups.size();
+    std::vector<long long> scaled;
+    std::vector<int> small, large;
+    for (std::map<PowerUp, int>::iterator i = loot_table.begin(); i != loot_table.end(); i++) {
+        scaled.push_back((*i).second * count);
+        if (scaled.back() < total_weight) {
+            small.push_back(scaled.size() - 1);
+        } else {
+            large.push_back(scaled.size() - 1);
+        }
+    }
+
+    thresholds.assign(count, total_weight);
+    aliases.assign(count, 0);
+    for (int i = 0; i < count; i++) {
+        aliases[i] = i;
+    }
+    while (!small.empty() && !large.empty()) {
+        int less = small.back(), more = large.back();
+        small.pop_back();
+        thresholds[less] = scaled[less];
+        aliases[less] = more;
+
+        scaled[more] -= total_weight - scaled[less];
+        if (scaled[more] < total_weight) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    cell_distribution = std::uniform_int_distribution<long long>(0, count * total_weight - 1);
+}
+
+// Restarts the random stream of the loot table. Tables with the same weights and seed draw the same power-ups.
+// seed: The seed of the random stream.
+void LootTable::seed(unsigned int seed) {
+    engine.seed(seed);
+}
+
+// Returns the weights of the power-ups in the loot table.
+std::map<PowerUp, int> LootTable::get_weights() {
+    return loot_table;
+}
+
+// Draws the index in power_ups of a random power-up, each with a chance proportional to its weight.
+int LootTable::draw_index() {
+    long long cell = cell_distribution(engine);
+    int column = cell / total_weight;
+    return cell % total_weight < thresholds[column] ? column : aliases[column];
 }
 
 // Draws a random power-up from the loot table and returns it.
-PowerUp LootTable::draw_power_up() {
-    int r = std::abs((int)engine());
-    int val = r % total_weight + 1;
+const PowerUp &LootTable::draw_power_up() {
+    return power_ups[draw_index()];
+}
 
-    int cum = 0;
-    for (std::map<PowerUp, int>::iterator i = loot_table.begin(); i != loot_table.end(); i++) {
-        cum += (*i).second;
-        if (cum >= val) {
-            return (*i).first;
-        }
+// Draws many random power-ups at once, the same as calling draw_power_up() that many times.
+// count: The number of power-ups to draw.
+// ids: The ids of the power-ups drawn are added to the end of this.
+void LootTable::draw_power_ups(int count, std::vector<int> &ids) {
+    size_t start = ids.size();
+    ids.resize(start + count);
+    for (int i = 0; i < count; i++) {
+        ids[start + i] = power_ups[draw_index()].id;
     }
-    // Fallback
-    throw std::invalid_argument("Something bad happened. " + std::to_string(r) + " " + std::to_string(val));
-    return (*loot_table.begin()).first;
 }
@@ -1,26 +1,40 @@
 #include "power_up.h"
 #include <map>
 #include <random>
+#include <vector>
 
 #ifndef LOOT_TABLE_H_
 #define LOOT_TABLE_H_
 
+// Draws power-ups at random, each with a chance proportional to its weight.
+// Draws take the same time however many power-ups the table has: the weights are turned into
+// an alias table (Vose's method) once, when the table is made.
 class LootTable {
 
     public:
         LootTable();
         LootTable(std::map<PowerUp, int> loot_table);
 
-        PowerUp draw_power_up();
+        const PowerUp &draw_power_up();
+        void draw_power_ups(int count, std::vector<int> &ids);
+        void seed(unsigned int seed);
+        std::map<PowerUp, int> get_weights();
 
     private:
         void init(std::map<PowerUp, int> loot_table);
         std::map<PowerUp, int> loot_table;
-        std::random_device rd;
         std::mt19937 engine;
 
-        int draw_num();
-        int total_weight;
+        int draw_index();
+        long long total_weight;
+
+        // The alias table. Column i is picked evenly, then gives power_ups[i] if a number drawn evenly
+        // from 0 to total_weight - 1 is below thresholds[i], and power_ups[aliases[i]] otherwise.
+        std::vector<PowerUp> power_ups;
+        std::vector<long long> thresholds;
+        std::vector<int> aliases;
+        // Draws a column and a number to compare with its threshold at once, as column * total_weight + number.
+        std::uniform_int_distribution<long long> cell_distribution;
 };
 
-#endif
\ No newline at end of file
+#endif
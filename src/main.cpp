@@ -1,14 +1,22 @@
 #include "game.h"
+#include "input_recorder.h"
+#include "level_pack.h"
 #include "menu.h"
+#include "trace.h"
 
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <random>
+#include <stdexcept>
 #include <string>
 
 Game game;
 Menu sample;
 std::vector<std::string> filenames;
 std::string level_index = "data/index.txt";
+std::string level_pack_file = "data/levels.pack";
+LevelPack level_pack;
 
 // Initializes the colors in ncurses so that they can be displayed.
 void init_color_pairs() {
@@ -67,8 +75,60 @@ bool run_menu() {
     return true;
 }
 
+// Prints how to start the game.
+void print_usage() {
+    std::cerr << "Usage: main [--seed n] [--record file] [--profile file] [--trace file] [--ansi] [--low-detail]" << std::endl;
+    std::cerr << "--seed: Play with a fixed seed, so that the same keys give the same game." << std::endl;
+    std::cerr << "--record: Record the keys of every frame, to be replayed with \"sim --replay file\"." << std::endl;
+    std::cerr << "--profile: Write how long each phase of every frame took to a CSV file." << std::endl;
+    std::cerr << "--trace: Write a trace of the session, to be opened in a trace viewer (e.g. chrome://tracing)." << std::endl;
+    std::cerr << "--ansi: Send only the changes to the playing field to the terminal, bypassing ncurses (for slow links)." << std::endl;
+    std::cerr << "--low-detail: Always draw the playing field with reduced detail, as is done when the terminal cannot keep up." << std::endl;
+}
+
 // The main method to run the game.
-int main() {
+int main(int argc, char *argv[]) {
+
+    unsigned int seed = std::random_device()();
+    InputRecorder *recorder = NULL;
+    std::string trace_file = "";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--ansi") {
+            game.set_ansi_output(true);
+            continue;
+        }
+        if (arg == "--low-detail") {
+            game.set_low_detail(true);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            print_usage();
+            return 1;
+        }
+        if (arg == "--seed") {
+            seed = (unsigned int)std::strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--record") {
+            recorder = new InputRecorder(argv[++i]);
+        } else if (arg == "--profile") {
+            game.set_profile_file(argv[++i]);
+        } else if (arg == "--trace") {
+            trace_file = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    game.set_seed(seed);
+    if (trace_file != "") {
+        start_tracing();
+        name_trace_thread("game");
+    }
+    if (recorder != NULL) {
+        game.set_recorder(*recorder);
+    }
 
     initscr();
     resize_term(50, 200);
@@ -76,24 +136,45 @@ int main() {
     start_color();
     init_color_pairs();
 
-    std::ifstream fin;
-
-    fin.open(level_index);
-    if (!fin.fail()) {
+    // The level pack holds every level and page in one file. Without one, the levels are listed in the index.
+    if (level_pack.open(level_pack_file)) {
+        filenames = level_pack.get_level_names();
+        game.set_level_pack(level_pack);
+        sample.set_level_pack(level_pack);
+    } else {
+        std::ifstream fin;
+        fin.open(level_index);
+        if (fin.fail()) {
+            endwin();
+            throw std::runtime_error("Failed to open " + level_index + ". Please check if it is missing.");
+        }
         std::string file_name;
         while (fin >> file_name) {
             if (file_name != "") {
                 filenames.push_back(file_name);
             }
         }
+    }
 
+    // A level with a mistake cannot be played, so the program ends with the error, which says where the mistake is
+    try {
         while (run_menu()) {
             continue;
         }
+    } catch (std::runtime_error &e) {
         endwin();
-    } else {
-        endwin();
-        throw std::runtime_error("Failed to open " + level_index + ". Please check if it is missing.");
+        delete recorder;
+        std::cerr << e.what() << std::endl;
+        // The trace shows what led up to the error, so it is kept as well
+        if (trace_file != "") {
+            write_trace(trace_file);
+        }
+        return 1;
     }
+    endwin();
+    delete recorder;
 
+    if (trace_file != "") {
+        write_trace(trace_file);
+    }
 }
@@ -0,0 +1,83 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+// Constructs a MappedFile with no file open.
+MappedFile::MappedFile() {}
+
+// Unmaps the file, if any.
+MappedFile::~MappedFile() {
+    close();
+}
+
+// Makes the whole of a file readable through data(). Returns true if the file could be read.
+// Any file opened before is closed first.
+// filename: The address of the file.
+bool MappedFile::open(std::string filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if ((size_t)info.st_size >= min_mapped_size) {
+        void *address = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            mapped = (const char *)address;
+            mapped_size = info.st_size;
+            ::close(fd);
+            return true;
+        }
+    }
+
+    // Read the file instead
+    buffer.resize(info.st_size);
+    size_t done = 0;
+    while (done < buffer.size()) {
+        ssize_t count = read(fd, buffer.data() + done, buffer.size() - done);
+        if (count <= 0) {
+            break;
+        }
+        done += count;
+    }
+    buffer.resize(done);
+    ::close(fd);
+    return true;
+}
+
+// Unmaps or frees the file. data() must not be used afterwards.
+void MappedFile::close() {
+    if (mapped != NULL) {
+        munmap((void *)mapped, mapped_size);
+        mapped = NULL;
+        mapped_size = 0;
+    }
+    buffer.clear();
+}
+
+// Returns the contents of the file.
+const char *MappedFile::data() {
+    return mapped != NULL ? mapped : buffer.data();
+}
+
+// Returns the size of the file in bytes.
+size_t MappedFile::size() {
+    return mapped != NULL ? mapped_size : buffer.size();
+}
+
+// Returns if the file is memory-mapped, rather than read into a buffer.
+bool MappedFile::is_mapped() {
+    return mapped != NULL;
+}
@@ -0,0 +1,36 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+// A whole file made readable in memory. Large files are memory-mapped if possible, so opening them costs no copying.
+// Small files, and files that cannot be mapped, are read into a buffer instead,
+// since setting up and tearing down a mapping costs more than copying a few pages.
+class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        bool open(std::string filename);
+        void close();
+
+        const char *data();
+        size_t size();
+        bool is_mapped();
+
+        // Files smaller than this many bytes are read rather than mapped.
+        static const size_t min_mapped_size = 64 * 1024;
+
+    private:
+        const char *mapped = NULL;
+        size_t mapped_size = 0;
+        std::vector<char> buffer;
+
+        // A mapping cannot be shared, so a MappedFile cannot be copied.
+        MappedFile(const MappedFile &other);
+        MappedFile &operator=(const MappedFile &other);
+};
+
+#endif
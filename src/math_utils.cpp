@@ -1,6 +1,7 @@
 #include "math_utils.h"
 
 #include <cmath>
+#include <random>
 
 #define M_PI 3.14159265358979323846
 
@@ -29,4 +30,15 @@ double lerp(double a, double b, double t) {
 // Returns the average of 2 numbers.
 double avg(double a, double b) {
     return (a + b) / 2;
-}
\ No newline at end of file
+}
+
+// Derives the seed of a separate random stream from a parent seed.
+// The same seed and stream always give the same result, and different streams give unrelated results.
+// seed: The parent seed.
+// stream: Which stream to derive, e.g. the number of the level.
+unsigned int derive_seed(unsigned int seed, unsigned int stream) {
+    std::seed_seq seq{seed, stream};
+    unsigned int result;
+    seq.generate(&result, &result + 1);
+    return result;
+}
@@ -5,5 +5,6 @@ double from_deg(double deg);
 double to_deg(double rad);
 double lerp(double a, double b, double t);
 double avg(double a, double b);
+unsigned int derive_seed(unsigned int seed, unsigned int stream);
 
 #endif
\ No newline at end of file
@@ -1,9 +1,11 @@
 #include "menu.h"
 #include "leaderboard.h"
+#include "level_pack.h"
 #include "ncu.h"
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 std::vector<std::string> exit_options = {"     Yes      ",
                                          "      No      "};
@@ -156,21 +158,36 @@ void Menu::run_credits_ui() {
     delwin(contributor_window);
 }
 
-// Uses ncurses to print out a page, which is a .txt file you can find in the data folder.
+// Sets the level pack to read the instruction pages from. Pages not in the pack are still read from their files.
+// level_pack: The opened level pack. It must outlive the menu.
+void Menu::set_level_pack(LevelPack &level_pack) {
+    Menu::level_pack = &level_pack;
+}
+
+// Uses ncurses to print out a page, which is a .txt file you can find in the data folder or in the level pack.
 // page_num: The page to be printed.
 void Menu::print_page(int page_num) {
     std::ifstream fin;
+    std::istringstream packed;
+    std::istream *page = &fin;
     std::string file_name = "data/instructions" + std::to_string(page_num) + ".txt";
-    fin.open(file_name);
 
-    if (fin.fail()) {
-        throw std::runtime_error("Cannot find " + file_name + ". Please check if the file exists.");
-        exit(1);
+    const char *data;
+    size_t size;
+    if (level_pack != NULL && level_pack->read(file_name, data, size)) {
+        packed.str(std::string(data, size));
+        page = &packed;
+    } else {
+        fin.open(file_name);
+        if (fin.fail()) {
+            throw std::runtime_error("Cannot find " + file_name + ". Please check if the file exists.");
+            exit(1);
+        }
     }
 
     std::string line;
     int line_num = 0;
-    while (std::getline(fin, line)) {
+    while (std::getline(*page, line)) {
         mvwprintw(how_to_play_window, line_num + 2, 5, line.c_str());
         line_num++;
     }
@@ -1,6 +1,7 @@
 #include <string>
 #include <vector>
 
+#include "level_pack.h"
 #include "ncu.h"
 
 #ifndef MENU_H_
@@ -15,6 +16,8 @@ class Menu {
         const int start_col = 0;
         int main_menu_choice = 0;
 
+        void set_level_pack(LevelPack &level_pack);
+
         void init_ui();
         void clear_ui(WINDOW *win);
         void update_choice(int ch, int option_count, int &choice);
@@ -45,6 +48,9 @@ class Menu {
         WINDOW *how_to_play_window;
         WINDOW *exit_window;
         WINDOW *pause_window;
+
+        // Pages are read from this pack when it has them, and from their files otherwise.
+        LevelPack *level_pack = NULL;
 };
 
 #endif
\ No newline at end of file
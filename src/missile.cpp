@@ -1,8 +1,8 @@
 #include "missile.h"
 #include "playing_field.h"
 #include "rect.h"
-#include "rect_block.h"
 
+#include <algorithm>
 #include <string>
 
 // Constructs a missile object.
@@ -20,22 +20,41 @@ void Missile::move() {
     pos.y += move_speed;
 }
 
+// Returns the position of the missile's tip.
+Vector2 Missile::get_pos() {
+    return pos;
+}
+
 // Returns if the missile has collided with a brick.
-// brick: The brick to check collision against.
-bool Missile::collide(RectBlock *brick) {
-    return brick->get_rect().contains_point(pos);
+// brick_rect: The rect of the brick to check collision against.
+bool Missile::collide(Rect brick_rect) {
+    return brick_rect.contains_point(pos);
 }
 
 // Returns if the missile has hit the top of the well (playing field).
 // well: The well to check collision against.
-bool Missile::hit_well(Well well) {
+bool Missile::hit_well(Well &well) {
     return !well.get_inner_box().contains_point(pos);
 }
 
+// Returns the range of cells on the screen that the missile is drawn on (starting and ending rows and columns).
+// pf: The playing field to draw on.
+// &r1: The starting row.
+// &r2: The ending row.
+// &c1: The starting column.
+// &c2: The ending column.
+// All 4 pass-by-reference variables are outputs of the function.
+// The part of the missile below the point it was fired from is not drawn, so the range can be empty.
+void Missile::get_drawing_range(PlayingField &pf, int &r1, int &r2, int &c1, int &c2) {
+    r1 = pf.row_y(pos.y);
+    r2 = std::min(r1 + 2, pf.row_y(base_y) - 1);
+    c1 = c2 = pf.col_x(pos.x);
+}
+
 // Displays the missile.
 // pf: The playing field to draw the missile on.
-void Missile::draw_pf(PlayingField pf) {
-    std::string art[3] = {"^", "|", "^"};
+void Missile::draw_pf(PlayingField &pf) {
+    static const char *const art[3] = {"^", "|", "^"};
     int base_r = pf.row_y(base_y);
     int r = pf.row_y(pos.y);
     int c_start = pf.col_x(pos.x);
@@ -43,7 +62,6 @@ void Missile::draw_pf(PlayingField pf) {
         if (r + i >= base_r) {
             break;
         }
-        wmove(pf.get_display_window(), r + i, c_start);
-        wprintw(pf.get_display_window(), art[i].c_str());
+        pf.get_render_target().put_string(r + i, c_start, art[i]);
     }
 }
@@ -1,5 +1,5 @@
 #include "playing_field.h"
-#include "rect_block.h"
+#include "rect.h"
 #include "well.h"
 
 #ifndef MISSILE_H_
@@ -9,9 +9,11 @@ class Missile {
     public:
         Missile(Vector2 pos, double move_speed);
         void move();
-        bool collide(RectBlock *bricks);
-        bool hit_well(Well well);
-        void draw_pf(PlayingField pf);
+        Vector2 get_pos();
+        bool collide(Rect brick_rect);
+        bool hit_well(Well &well);
+        void get_drawing_range(PlayingField &pf, int &r1, int &r2, int &c1, int &c2);
+        void draw_pf(PlayingField &pf);
 
     private:
         Vector2 pos;
@@ -1,4 +1,11 @@
 // This file is included for compatibility purposes.
 // We used Windows to develop our game, and the ncurses library is located in <ncurses/curses.h>.
 // However, in Linux, it is located in <curses.h> (no ncurses folder).
-#include <ncurses/curses.h>
\ No newline at end of file
+//
+// When HEADLESS is defined (see the "sim" target in the makefile), the game is compiled
+// against a set of no-op stand-ins instead, so that it can run without a terminal.
+#ifdef HEADLESS
+#include "ncu_headless.h"
+#else
+#include <ncurses/curses.h>
+#endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef NCU_HEADLESS_H_
+#define NCU_HEADLESS_H_
+
+// No-op replacements for the parts of ncurses used by the simulation code.
+// Only included by ncu.h when compiling with -DHEADLESS. Nothing is ever drawn,
+// no window is ever created and no key is ever read from the terminal.
+
+typedef struct HeadlessWindow WINDOW;
+typedef unsigned long chtype;
+
+// Values match the ones in <curses.h>, so that recorded inputs mean the same thing in both builds.
+#define ERR (-1)
+#define OK (0)
+#define KEY_DOWN 0402
+#define KEY_UP 0403
+#define KEY_LEFT 0404
+#define KEY_RIGHT 0405
+#define KEY_BACKSPACE 0407
+
+#define A_NORMAL 0UL
+#define COLOR_PAIR(n) ((chtype)(n) << 8)
+
+#define getmaxyx(win, y, x) ((y) = 0, (x) = 0)
+
+inline WINDOW *newwin(int, int, int, int) { return 0; }
+inline int wgetch(WINDOW *) { return ERR; }
+inline int napms(int) { return OK; }
+inline int werase(WINDOW *) { return OK; }
+inline int wrefresh(WINDOW *) { return OK; }
+inline int wnoutrefresh(WINDOW *) { return OK; }
+inline int doupdate() { return OK; }
+inline int wmove(WINDOW *, int, int) { return OK; }
+inline int wprintw(WINDOW *, const char *, ...) { return OK; }
+inline int mvwaddstr(WINDOW *, int, int, const char *) { return OK; }
+inline int mvwaddch(WINDOW *, int, int, chtype) { return OK; }
+inline int mvwaddchnstr(WINDOW *, int, int, const chtype *, int) { return OK; }
+inline int wattrset(WINDOW *, chtype) { return OK; }
+inline int wattron(WINDOW *, chtype) { return OK; }
+inline int wattroff(WINDOW *, chtype) { return OK; }
+inline int whline(WINDOW *, chtype, int) { return OK; }
+inline int wvline(WINDOW *, chtype, int) { return OK; }
+inline int wborder(WINDOW *, chtype, chtype, chtype, chtype, chtype, chtype, chtype, chtype) { return OK; }
+
+#endif
@@ -3,7 +3,7 @@
 
 #include <algorithm>
 #include <cmath>
-#include <string>
+#include <cstring>
 
 // Constructs a notification bar with the given dimensions.
 // w: The width of the bar.
@@ -22,38 +22,47 @@ void NotificationBar::set_display_window(int y_start) {
 
 // Displays a piece of text. If other text is being displayed,
 // the notification bar puts it in a queue and displays it later.
-void NotificationBar::display(std::string s) {
-    if (s != "") {
-        msg_queue.push_back(s);
+void NotificationBar::display(const char *s) {
+    if (s[0] != '\0' && queue_size < max_queued) {
+        char *slot = msg_queue[(queue_front + queue_size) % max_queued];
+        std::strncpy(slot, s, max_message_length);
+        slot[max_message_length] = '\0';
+        ++queue_size;
     }
 }
 
 // Updates the notification bar to display the current message.
 // Text to display will be centered in the bar.
+// The window is staged with wnoutrefresh(), and shown with the next frame of the playing field.
 void NotificationBar::update() {
     werase(display_window);
-    if (msg != "") {
+    if (msg[0] != '\0') {
         int mid_x = width / 2, mid_y = height / 2;
-        wmove(display_window, mid_y, mid_x - msg.length() / 2);
-        wprintw(display_window, msg.c_str());
+        wmove(display_window, mid_y, mid_x - std::strlen(msg) / 2);
+        wprintw(display_window, msg);
     }
-    wrefresh(display_window);
+    wnoutrefresh(display_window);
 }
 
-// Sets the current message to show.
+// Sets the current message to show. The bar is only drawn again if the message changes,
+// so an idle bar (which sets an empty message every frame) costs nothing.
 // message: The current message to show.
-void NotificationBar::set_message(std::string message) {
-    msg = message;
+void NotificationBar::set_message(const char *message) {
+    if (std::strcmp(message, msg) == 0) {
+        return;
+    }
+    std::strcpy(msg, message);
     update();
 }
 
 // If a message is queued, show the next message. Otherwise, show nothing.
 // By default, each message is shown for 50 frames, which will be decreased if many messages are queued.
 void NotificationBar::show_next_message() {
-    if (msg_queue.size() > 0) {
-        set_message(msg_queue.front());
-        msg_queue.pop_front();
-        timer = std::max(15.0, 50 - std::pow(msg_queue.size(), 3));
+    if (queue_size > 0) {
+        set_message(msg_queue[queue_front]);
+        queue_front = (queue_front + 1) % max_queued;
+        --queue_size;
+        timer = std::max(15.0, 50 - std::pow(queue_size, 3));
     } else {
         set_message("");
     }
@@ -71,10 +80,11 @@ void NotificationBar::tick() {
 }
 
 // Resets the notification bar, which clears its message queue.
+// The bar is always drawn again, to clear whatever else was drawn in its place.
 void NotificationBar::reset() {
     timer = 0;
-    set_message("");
-    while (msg_queue.size() > 0) {
-        msg_queue.pop_front();
-    }
+    msg[0] = '\0';
+    update();
+    queue_front = 0;
+    queue_size = 0;
 }
@@ -1,7 +1,7 @@
 #include "ncu.h"
 
-#include <list>
-#include <string>
+#include <cstddef>
+
 
 #ifndef NOTIFICATION_BAR_H
 #define NOTIFICATION_BAR_H
@@ -11,17 +11,24 @@ class NotificationBar {
     public:
         NotificationBar(int w, int h);
         void set_display_window(int y_start);
-        void display(std::string s);
+        void display(const char *s);
         void tick();
         void update();
         void reset();
 
     private:
+        // The longest message (longer ones are cut short), and the most messages that can wait to be shown
+        // (messages that arrive while the queue is full are dropped).
+        static const int max_message_length = 63;
+        static const int max_queued = 16;
+
         int width, height, timer = 0;
-        std::list<std::string> msg_queue;
-        std::string msg;
+        // The messages waiting to be shown, in a ring, so that showing a message never allocates.
+        char msg_queue[max_queued][max_message_length + 1];
+        int queue_front = 0, queue_size = 0;
+        char msg[max_message_length + 1] = "";
         WINDOW *display_window = NULL;
-        void set_message(std::string message);
+        void set_message(const char *message);
         void show_next_message();
 };
 
@@ -0,0 +1,112 @@
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef OBJECT_POOL_H_
+#define OBJECT_POOL_H_
+
+// A fixed number of slots for objects of one type, allocated once up front.
+// Getting and returning an object is O(1) and never touches the heap,
+// which keeps short-lived objects (balls, missiles, power-up drops) cheap to create.
+template <typename T>
+class ObjectPool {
+    public:
+        explicit ObjectPool(int capacity);
+        ~ObjectPool();
+
+        template <typename... Args>
+        T *acquire(Args &&...args);
+        void release(T *object);
+
+        int capacity();
+        int in_use();
+        int peak();
+
+    private:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+        Slot *slots;
+        std::vector<unsigned char> live;
+        std::vector<int> free_slots;
+        int size, used = 0, peak_used = 0;
+
+        // A pool owns its objects, so it cannot be copied.
+        ObjectPool(const ObjectPool &);
+        ObjectPool &operator=(const ObjectPool &);
+};
+
+// Creates a pool with room for a fixed number of objects.
+// capacity: The most objects that can exist at once.
+template <typename T>
+ObjectPool<T>::ObjectPool(int capacity) {
+    size = capacity;
+    slots = new Slot[capacity];
+    live.assign(capacity, 0);
+    free_slots.reserve(capacity);
+    for (int i = capacity - 1; i >= 0; i--) {
+        free_slots.push_back(i);
+    }
+}
+
+// Destroys any objects that were never released, and frees the slots.
+template <typename T>
+ObjectPool<T>::~ObjectPool() {
+    for (int i = 0; i < size; i++) {
+        if (live[i]) {
+            reinterpret_cast<T *>(&slots[i])->~T();
+        }
+    }
+    delete[] slots;
+}
+
+// Constructs an object in a free slot and returns it.
+// Returns NULL if every slot is taken.
+// args: The arguments passed to the object's constructor.
+template <typename T>
+template <typename... Args>
+T *ObjectPool<T>::acquire(Args &&...args) {
+    if (free_slots.empty()) {
+        return NULL;
+    }
+    int i = free_slots.back();
+    free_slots.pop_back();
+    live[i] = 1;
+
+    ++used;
+    if (used > peak_used) {
+        peak_used = used;
+    }
+    return new (&slots[i]) T(std::forward<Args>(args)...);
+}
+
+// Destroys an object and frees its slot. The object must have come from this pool.
+// object: The object to release.
+template <typename T>
+void ObjectPool<T>::release(T *object) {
+    int i = reinterpret_cast<Slot *>(object) - slots;
+    object->~T();
+    live[i] = 0;
+    free_slots.push_back(i);
+    --used;
+}
+
+// Returns the most objects that can exist at once.
+template <typename T>
+int ObjectPool<T>::capacity() {
+    return size;
+}
+
+// Returns the number of objects that currently exist.
+template <typename T>
+int ObjectPool<T>::in_use() {
+    return used;
+}
+
+// Returns the most objects that have existed at once since the pool was created.
+template <typename T>
+int ObjectPool<T>::peak() {
+    return peak_used;
+}
+
+#endif
@@ -2,6 +2,7 @@
 #include "math_utils.h"
 #include "playing_field.h"
 #include "rect.h"
+#include "render_target.h"
 #include "rect_wall.h"
 #include "well.h"
 
@@ -21,39 +22,43 @@ Paddle::Paddle(Vector2 pos, double base_length, double thickness) {
 }
 
 // Returns the current length of the paddle, including the effect from paddle power-ups.
-double Paddle::length() {
+double Paddle::length() const {
     return base_length + 2 * buffs;
 }
 
+// Returns the range of cells on the screen that the paddle is drawn on (starting and ending rows and columns).
+// pfield: The playing field to draw on.
+// &r1: The starting row.
+// &r2: The ending row.
+// &c1: The starting column.
+// &c2: The ending column.
+// All 4 pass-by-reference variables are outputs of the function.
+void Paddle::get_drawing_range(PlayingField &pfield, int &r1, int &r2, int &c1, int &c2) {
+    c1 = pfield.col_x(pos.x - length() / 2);
+    c2 = pfield.col_x(pos.x + length() / 2);
+    r1 = r2 = pfield.row_y(pos.y);
+}
+
 // Displays the paddle.
 // pfield: The playing field to draw the paddle on.
-void Paddle::draw_pf(PlayingField pfield) {
-    int c1 = pfield.col_x(pos.x - length() / 2);
-    int c2 = pfield.col_x(pos.x + length() / 2);
-    int r1 = pfield.row_y(pos.y);
-
-    for (int c = c1; c <= c2; c++) {
-        wmove(pfield.get_display_window(), r1, c);
-        if (c == c1) {
-            wprintw(pfield.get_display_window(), "[");
-        }
-        if (c == c2) {
-            wprintw(pfield.get_display_window(), "]");
-        }
-        if (c != c1 && c != c2) {
-            wprintw(pfield.get_display_window(), "-");
-        }
-    }
+void Paddle::draw_pf(PlayingField &pfield) {
+    int r1, r2, c1, c2;
+    get_drawing_range(pfield, r1, r2, c1, c2);
+
+    RenderTarget &target = pfield.get_render_target();
+    target.fill_row(r1, c1 + 1, '-', c2 - c1 - 1);
+    target.put_char(r1, c1, '[');
+    target.put_char(r1, c2, ']');
 }
 
 // Returns the hitbox of the paddle as a Rect.
-Rect Paddle::get_paddle_hitbox() {
+Rect Paddle::get_paddle_hitbox() const {
     return Rect::get_rect(pos, {length(), thickness});
 }
 
 // Returns the paddle's hitbox for the ball, which is slightly larger than its true hitbox.
 // This is to implement a grace mechanism to make the game easier and feel better.
-Rect Paddle::get_ball_hitbox() {
+Rect Paddle::get_ball_hitbox() const {
     Rect hitbox = get_paddle_hitbox();
     return {hitbox.pos1.add({-1, 0}), hitbox.pos2.add({1, 0.5})};
 }
@@ -61,14 +66,14 @@ Rect Paddle::get_ball_hitbox() {
 // Returns whether the given position is within the paddle's "ball hitbox".
 // arg_x: The x-coordinate of the position.
 // arg_y: The y-coordinate of the position.
-bool Paddle::can_hit_ball(Vector2 ball_pos) {
+bool Paddle::can_hit_ball(Vector2 ball_pos) const {
     return get_ball_hitbox().contains_point(ball_pos);
 }
 
 // Receives input from the keyboard to move the paddle.
 // ch: The key pressed, translated to an int as determined by ncurses.
 // well: The well in the playing field. Used to prevent the paddle from clipping into the wall.
-void Paddle::move_by_input(int ch, Well well) {
+void Paddle::move_by_input(int ch, Well &well) {
     double offset = 0;
     if (ch == KEY_LEFT || ch == KEY_UP) {
         offset = -1.0;
@@ -86,7 +91,7 @@ void Paddle::move_by_input(int ch, Well well) {
 // Get the ball's deflection angle depending on where the ball hit the paddle.
 // Balls that hit the left of the paddle bounce to the left and vice versa.
 // The closer to the edge that the ball hits, the further the ball will be deflected to the side.
-double Paddle::get_deflection_angle(double arg_x) {
+double Paddle::get_deflection_angle(double arg_x) const {
     Rect ball_hitbox = get_ball_hitbox();
     double ratio = (arg_x - ball_hitbox.pos1.x) / (ball_hitbox.pos2.x - ball_hitbox.pos1.x);
     return lerp(leftmost_deflect_angle, rightmost_deflect_angle, ratio);
@@ -96,7 +101,7 @@ double Paddle::get_deflection_angle(double arg_x) {
 // Returns true if the buff can be applied, false if it fails to be applied.
 // well: The well in the playing field.
 // Used to make sure the size of the paddle won't exceed the size of the well.
-bool Paddle::buff(Well well) {
+bool Paddle::buff(Well &well) {
     if (buffs < 2) {
         ++buffs;
         Rect hitbox = get_paddle_hitbox();
@@ -133,7 +138,7 @@ bool Paddle::nerf() {
 // Resets the width of the paddle.
 // well: The well in playing field.
 // Used to make sure the size of the paddle won't exceed the size of the well.
-void Paddle::reset_width(Well well) {
+void Paddle::reset_width(Well &well) {
     if (buffs < 0) {
         while (buffs != 0) {
             buff(well);
@@ -144,4 +149,4 @@ void Paddle::reset_width(Well well) {
 }
 
 // Returns the paddle's position.
-Vector2 Paddle::get_pos() { return pos; }
+Vector2 Paddle::get_pos() const { return pos; }
@@ -8,19 +8,20 @@
 class Paddle {
     public:
         Paddle(Vector2 pos, double base_length, double thickness);
-        double length();
+        double length() const;
 
-        void draw_pf(PlayingField pfield);
-        Rect get_paddle_hitbox();
-        Rect get_ball_hitbox();
-        bool can_hit_ball(Vector2 ball_pos);
-        void move_by_input(int ch, Well well);
-        double get_deflection_angle(double arg_x);
-        Vector2 get_pos();
+        void get_drawing_range(PlayingField &pfield, int &r1, int &r2, int &c1, int &c2);
+        void draw_pf(PlayingField &pfield);
+        Rect get_paddle_hitbox() const;
+        Rect get_ball_hitbox() const;
+        bool can_hit_ball(Vector2 ball_pos) const;
+        void move_by_input(int ch, Well &well);
+        double get_deflection_angle(double arg_x) const;
+        Vector2 get_pos() const;
 
-        bool buff(Well well);
+        bool buff(Well &well);
         bool nerf();
-        void reset_width(Well well);
+        void reset_width(Well &well);
 
     private:
         Vector2 pos;
@@ -1,6 +1,7 @@
 #include "playing_field.h"
 #include "ncu.h"
 
+#include <algorithm>
 #include <cmath>
 
 const double kImageX = 2.0;
@@ -11,13 +12,14 @@ const double kImageY = 1.0;
 // height: The height of the playing field.
 PlayingField::PlayingField(Vector2 size) {
     PlayingField::size = size;
+    max_x = (int)ceil(size.x * kImageX);
+    max_y = (int)ceil(size.y * kImageY);
 }
 
-// Sets up a window in ncurses. This needs to be done after ncurses has been initialized.
+// Sets up a window in ncurses to draw to. This needs to be done after ncurses has been initialized.
 void PlayingField::set_display_window() {
-    max_x = (int)ceil(size.x * kImageX);
-    max_y = (int)ceil(size.y * kImageY);
     display_window = newwin(max_y, max_x, 6, 0);
+    window_target = CursesTarget(display_window);
 }
 
 // When the game is being simulated, the positions, velocities, etc. are being stored as doubles.
@@ -39,7 +41,76 @@ int PlayingField::row_y(double y) {
     return (int)(round((size.y / 2 - y) * kImageY));
 }
 
+// Returns a rectangle in the simulation that covers every position drawn inside the given cells.
+// It is slightly larger than the cells, so anything that rounds into them is inside it.
+// box: The cells on the screen.
+Rect PlayingField::get_cell_area(CellBox box) {
+    double x1 = (box.c1 - 1) / kImageX - size.x / 2;
+    double x2 = (box.c2 + 1) / kImageX - size.x / 2;
+    double y1 = size.y / 2 - (box.r2 + 1) / kImageY;
+    double y2 = size.y / 2 - (box.r1 - 1) / kImageY;
+    return {x1, y1, x2, y2};
+}
+
 // Returns the display window as a pointer.
 WINDOW *PlayingField::get_display_window() {
     return display_window;
-}
\ No newline at end of file
+}
+
+// Draws the playing field to another target from now on, instead of the display window.
+// target: The target, which must be max_y rows by max_x columns. It must outlive its use by the playing field.
+void PlayingField::set_render_target(RenderTarget &target) {
+    PlayingField::target = &target;
+}
+
+// Draws the playing field to the display window again.
+void PlayingField::reset_render_target() {
+    target = NULL;
+}
+
+// Returns the target that the playing field is drawn to.
+RenderTarget &PlayingField::get_render_target() {
+    if (target == NULL) {
+        return window_target;
+    }
+    return *target;
+}
+
+// Sets whether the playing field is drawn with reduced detail, for terminals that cannot keep up.
+// With reduced detail, only every other frame is drawn, bricks are drawn without their sides, and the cells
+// cleared in a frame are merged into fewer blocks.
+// reduced: Whether to reduce the detail.
+void PlayingField::set_reduced_detail(bool reduced) {
+    reduced_detail = reduced;
+}
+
+// Returns if the playing field is drawn with reduced detail.
+bool PlayingField::is_reduced_detail() {
+    return reduced_detail;
+}
+
+// Returns if the box covers no cells.
+bool CellBox::is_empty() {
+    return r2 < r1 || c2 < c1;
+}
+
+// Returns if the box shares at least one cell with another box.
+// other: The other box.
+bool CellBox::intersects(CellBox other) {
+    if (is_empty() || other.is_empty()) {
+        return false;
+    }
+    return r1 <= other.r2 && other.r1 <= r2 && c1 <= other.c2 && other.c1 <= c2;
+}
+
+// Returns the smallest box that covers both this box and another one.
+// other: The other box.
+CellBox CellBox::bounding_box(CellBox other) {
+    return {std::min(r1, other.r1), std::max(r2, other.r2), std::min(c1, other.c1), std::max(c2, other.c2)};
+}
+
+// Returns the cells shared with another box, which is empty if there are none.
+// other: The other box.
+CellBox CellBox::intersection(CellBox other) {
+    return {std::max(r1, other.r1), std::min(r2, other.r2), std::max(c1, other.c1), std::min(c2, other.c2)};
+}
@@ -1,14 +1,36 @@
+#include "curses_target.h"
 #include "ncu.h"
+#include "rect.h"
+#include "render_target.h"
 #include "vector2.h"
 
+#include <cstddef>
+
 #ifndef PLAYING_FIELD_H_
 #define PLAYING_FIELD_H_
 
+// A block of cells on the screen, from row r1 to r2 and column c1 to c2 (inclusive).
+// A box with r2 < r1 or c2 < c1 covers no cells.
+struct CellBox {
+    int r1, r2, c1, c2;
+
+    bool is_empty();
+    bool intersects(CellBox other);
+    CellBox intersection(CellBox other);
+    CellBox bounding_box(CellBox other);
+};
+
 // Container for the region for physics/game simulation. Includes an ncurses window.
+// Everything in the playing field is drawn through its render target, which is the window unless another
+// target (e.g. a FrameBuffer) is set.
 class PlayingField {
     private:
-        WINDOW *display_window;
+        WINDOW *display_window = NULL;
+        CursesTarget window_target;
+        // The target set with set_render_target(), or NULL to draw to the window.
+        RenderTarget *target = NULL;
         Vector2 size;
+        bool reduced_detail = false;
 
     public:
         int max_x, max_y;
@@ -17,7 +39,13 @@ class PlayingField {
         void set_display_window();
         int col_x(double x);
         int row_y(double y);
+        Rect get_cell_area(CellBox box);
         WINDOW *get_display_window();
+        void set_render_target(RenderTarget &target);
+        void reset_render_target();
+        RenderTarget &get_render_target();
+        void set_reduced_detail(bool reduced);
+        bool is_reduced_detail();
 };
 
 // row,"r" and col,"c" are the coordinates used in drawing to ncurses window
@@ -11,6 +11,9 @@ struct PowerUp {
         bool operator<(const PowerUp &a) const {
             return id < a.id;
         };
+        bool operator==(const PowerUp &a) const {
+            return id == a.id;
+        };
 };
 
 #endif
\ No newline at end of file
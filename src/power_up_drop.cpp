@@ -1,6 +1,7 @@
 #include "power_up_drop.h"
 #include "playing_field.h"
 #include "rect.h"
+#include "render_target.h"
 
 // Constructs (spawns) a dropping power-up on the playing field.
 // pos: The spawning position.
@@ -28,7 +29,7 @@ bool PowerUpDrop::collide(Paddle paddle) {
 // Returns if the power-up has fallen outside of the playing field.
 // Used for detecting if it should be destroyed.
 // well: The well of the playing field.
-bool PowerUpDrop::outside_well(Well well) {
+bool PowerUpDrop::outside_well(Well &well) {
     return well.is_below_well(pos.y);
 }
 
@@ -37,23 +38,30 @@ double PowerUpDrop::next_y() {
     return pos.y - move_speed;
 }
 
+// Returns the range of cells on the screen that the power-up is drawn on (starting and ending rows and columns).
+// pf: The playing field to draw on.
+// &r1: The starting row.
+// &r2: The ending row.
+// &c1: The starting column.
+// &c2: The ending column.
+// All 4 pass-by-reference variables are outputs of the function.
+void PowerUpDrop::get_drawing_range(PlayingField &pf, int &r1, int &r2, int &c1, int &c2) {
+    r1 = r2 = pf.row_y(pos.y);
+    c1 = pf.col_x(pos.x - 1);
+    c2 = c1 + (int)powerup.symbol.size() - 1;
+}
+
 // Displays the power-up.
 // pf: The playing field to draw the power-up on.
-void PowerUpDrop::draw_pf(PlayingField pf) {
+void PowerUpDrop::draw_pf(PlayingField &pf) {
     int r = pf.row_y(pos.y);
     int c_start = pf.col_x(pos.x - 1);
-    wmove(pf.get_display_window(), r, c_start);
-    if (powerup.id == 2 || powerup.id == 3) {
-        wattron(pf.get_display_window(), COLOR_PAIR(8));
-    } else {
-        wattron(pf.get_display_window(), COLOR_PAIR(16));
-    }
-    wprintw(pf.get_display_window(), powerup.symbol.c_str());
+    RenderTarget &target = pf.get_render_target();
     if (powerup.id == 2 || powerup.id == 3) {
-        wattroff(pf.get_display_window(), COLOR_PAIR(8));
+        target.set_color(8);
     } else {
-        wattron(pf.get_display_window(), COLOR_PAIR(16));
+        target.set_color(16);
     }
-    wattroff(pf.get_display_window(), COLOR_PAIR(8));
-    wattroff(pf.get_display_window(), COLOR_PAIR(16));
+    target.put_string(r, c_start, powerup.symbol.c_str());
+    target.set_color(0);
 }
@@ -12,9 +12,10 @@ class PowerUpDrop {
         PowerUpDrop(Vector2 pos, double move_speed, PowerUp powerup);
         void move();
         bool collide(Paddle paddle);
-        bool outside_well(Well well);
+        bool outside_well(Well &well);
         double next_y();
-        void draw_pf(PlayingField pf);
+        void get_drawing_range(PlayingField &pf, int &r1, int &r2, int &c1, int &c2);
+        void draw_pf(PlayingField &pf);
         PowerUp powerup;
 
     private:
@@ -1,6 +1,9 @@
 #include "rect.h"
 #include "math_utils.h"
 
+#include <algorithm>
+#include <limits>
+
 // Creates a rect given a center and the rect's size (static function).
 // center: The center coordinates of the rect.
 // size: The width and height of the rect.
@@ -12,6 +15,13 @@ Rect Rect::get_rect(Vector2 center, Vector2 size) {
     return {x1, y1, x2, y2};
 }
 
+// Creates the smallest rect containing two points (static function).
+// a: The first point.
+// b: The second point.
+Rect Rect::get_bounding_rect(Vector2 a, Vector2 b) {
+    return {std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.x, b.x), std::max(a.y, b.y)};
+}
+
 // Returns if a point is contained within this rect.
 // pos: The point to check.
 bool Rect::contains_point(Vector2 pos) {
@@ -24,6 +34,48 @@ bool Rect::contains_rect(Rect other) {
     return other.pos1.on_top_right_of(pos1) && pos2.on_top_right_of(other.pos2);
 }
 
+// Finds when a point moving in a straight line first enters this rect (a swept ray vs box test).
+// Returns true if it enters within the movement, i.e. some time between 0 and 1.
+// A point that starts inside the rect, or only leaves it, does not count as a hit.
+// origin: Where the point starts.
+// move: How far the point moves in total.
+// &time: Output, the fraction of the movement completed when the point touches the rect.
+// &hit_x: Output, whether it touches a left or right side. Both outputs are true for a corner.
+// &hit_y: Output, whether it touches the top or the bottom side.
+bool Rect::sweep(Vector2 origin, Vector2 move, double &time, bool &hit_x, bool &hit_y) {
+    const double inf = std::numeric_limits<double>::infinity();
+    double enter_x = -inf, exit_x = inf, enter_y = -inf, exit_y = inf;
+
+    if (move.x != 0) {
+        double t1 = (pos1.x - origin.x) / move.x;
+        double t2 = (pos2.x - origin.x) / move.x;
+        enter_x = std::min(t1, t2);
+        exit_x = std::max(t1, t2);
+    } else if (origin.x < pos1.x || origin.x > pos2.x) {
+        return false;
+    }
+
+    if (move.y != 0) {
+        double t1 = (pos1.y - origin.y) / move.y;
+        double t2 = (pos2.y - origin.y) / move.y;
+        enter_y = std::min(t1, t2);
+        exit_y = std::max(t1, t2);
+    } else if (origin.y < pos1.y || origin.y > pos2.y) {
+        return false;
+    }
+
+    double enter = std::max(enter_x, enter_y);
+    double exit = std::min(exit_x, exit_y);
+    if (enter > exit || enter < 0 || enter > 1) {
+        return false;
+    }
+
+    time = enter;
+    hit_x = enter_x >= enter_y;
+    hit_y = enter_y >= enter_x;
+    return true;
+}
+
 // Returns the top-left coordinates of the rect.
 Vector2 Rect::top_left() {
     return {pos1.x, pos2.y};
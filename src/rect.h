@@ -10,9 +10,11 @@ struct Rect {
         Vector2 pos1, pos2;
 
         static Rect get_rect(Vector2 center, Vector2 size);
+        static Rect get_bounding_rect(Vector2 a, Vector2 b);
 
         bool contains_point(Vector2 pos);
         bool contains_rect(Rect other);
+        bool sweep(Vector2 origin, Vector2 move, double &time, bool &hit_x, bool &hit_y);
 
         Vector2 top_left();
         Vector2 top_center();
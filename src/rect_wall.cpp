@@ -2,7 +2,9 @@
 #include "ncu.h"
 #include "playing_field.h"
 #include "rect.h"
+#include "render_target.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -33,7 +35,7 @@ void RectWall::set_filler(char filler){
 // &c1: The starting column.
 // &c2: The ending column.
 // All 4 pass-by-reference variables are outputs of the function.
-void RectWall::get_drawing_range(PlayingField pfield, int &r1, int &r2, int &c1, int &c2){
+void RectWall::get_drawing_range(PlayingField &pfield, int &r1, int &r2, int &c1, int &c2){
     r1 = pfield.row_y(rect.pos2.y);
     r2 = pfield.row_y(rect.pos1.y);
     c1 = pfield.col_x(rect.pos1.x);
@@ -43,51 +45,90 @@ void RectWall::get_drawing_range(PlayingField pfield, int &r1, int &r2, int &c1,
 // Draws on the screen with the fill pattern.
 // This fills a rectangle on the screen with the filler character.
 // pfield: The playing field to draw on.
-void RectWall::draw_fill(PlayingField pfield){
+void RectWall::draw_fill(PlayingField &pfield){
     int r1, r2, c1, c2;
     get_drawing_range(pfield, r1, r2, c1, c2);
 
+    RenderTarget &target = pfield.get_render_target();
+    target.set_color(clr0);
     for (int r = r1; r <= r2; r++) {
-        for (int c = c1; c <= c2; c++) {
-            wattrset(pfield.get_display_window(), COLOR_PAIR(clr0));
-            wmove(pfield.get_display_window(), r, c);
-            wprintw(pfield.get_display_window(), "%c", filler);
-        }
+        target.fill_row(r, c1, filler, c2 - c1 + 1);
     }
 }
 
 // Draws on the screen with the frame pattern.
 // This draws only the corners (with '+') and the edges (with '-' and '|').
+// With reduced detail, the sides ('|') are left out, as each of their cells costs a cursor movement to send.
 // pfield: The playing field to draw on.
-void RectWall::draw_frame(PlayingField pfield){
+void RectWall::draw_frame(PlayingField &pfield){
     int r1, r2, c1, c2;
     get_drawing_range(pfield, r1, r2, c1, c2);
 
-    wattrset(pfield.get_display_window(), COLOR_PAIR(clr0));
-    wmove(pfield.get_display_window(), r1, c1 + 1);
-    whline(pfield.get_display_window(), '-', c2 - c1);
-    wmove(pfield.get_display_window(), r2, c1 + 1);
-    whline(pfield.get_display_window(), '-', c2 - c1);
-    wmove(pfield.get_display_window(), r1 + 1, c1);
-    wvline(pfield.get_display_window(), '|', r2 - r1);
-    wmove(pfield.get_display_window(), r1 + 1, c2);
-    wvline(pfield.get_display_window(), '|', r2 - r1);
-
-    mvwaddstr(pfield.get_display_window(), r1, c1, "+");
-    mvwaddstr(pfield.get_display_window(), r1, c2, "+");
-    mvwaddstr(pfield.get_display_window(), r2, c1, "+");
-    mvwaddstr(pfield.get_display_window(), r2, c2, "+");
+    RenderTarget &target = pfield.get_render_target();
+    target.set_color(clr0);
+    target.fill_row(r1, c1 + 1, '-', c2 - c1);
+    target.fill_row(r2, c1 + 1, '-', c2 - c1);
+    if (!pfield.is_reduced_detail()) {
+        target.fill_column(r1 + 1, c1, '|', r2 - r1);
+        target.fill_column(r1 + 1, c2, '|', r2 - r1);
+    }
+
+    target.put_char(r1, c1, '+');
+    target.put_char(r1, c2, '+');
+    target.put_char(r2, c1, '+');
+    target.put_char(r2, c2, '+');
 }
 
 // Draws this RectWall on the screen.
 // pfield: The playing field to draw on.
-void RectWall::draw_to_pf(PlayingField pfield) {
-    wattron(pfield.get_display_window(), 0);
+void RectWall::draw_to_pf(PlayingField &pfield) {
     if (pattern == 0) draw_frame(pfield);
     if (pattern == 1) draw_fill(pfield);
-    wattrset(pfield.get_display_window(), 0);
-    //wattroff(pfield.get_display_window(), 0);
+    pfield.get_render_target().set_color(0);
+}
+
+// Draws only the part of this RectWall that lies inside the given cells, with the same pattern as draw_to_pf().
+// pfield: The playing field to draw on.
+// clip: The cells to draw in.
+void RectWall::draw_to_pf(PlayingField &pfield, CellBox clip) {
+    CellBox range;
+    get_drawing_range(pfield, range.r1, range.r2, range.c1, range.c2);
+    if (!range.intersects(clip)) {
+        return;
+    }
+
+    int r1 = std::max(range.r1, clip.r1), r2 = std::min(range.r2, clip.r2);
+    int c1 = std::max(range.c1, clip.c1), c2 = std::min(range.c2, clip.c2);
+
+    // Each row is drawn as one span
+    RenderTarget &target = pfield.get_render_target();
+    target.set_color(clr0);
+    for (int r = r1; r <= r2; r++) {
+        bool edge_r = r == range.r1 || r == range.r2;
+        if (pattern != 0) {
+            target.fill_row(r, c1, filler, c2 - c1 + 1);
+            continue;
+        }
+        // A frame has '-' along the top and bottom, '|' down the sides and '+' in the corners,
+        // and the inside of it is left as it is
+        if (edge_r) {
+            target.fill_row(r, c1, '-', c2 - c1 + 1);
+        } else if (pfield.is_reduced_detail()) {
+            continue;
+        }
+        char corner = edge_r ? '+' : '|';
+        if (c1 == range.c1) {
+            target.put_char(r, c1, corner);
+        }
+        if (c2 == range.c2) {
+            target.put_char(r, c2, corner);
+        }
+    }
+    target.set_color(0);
 }
 
 // Returns the rect that this wall occupies.
-Rect RectWall::get_rect() { return rect; }
\ No newline at end of file
+Rect RectWall::get_rect() { return rect; }
+
+// Returns the color code of this wall.
+int RectWall::get_color() { return clr0; }
\ No newline at end of file
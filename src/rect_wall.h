@@ -12,14 +12,16 @@ class RectWall {
     public:
         RectWall(Rect rect, int clr0 = 0);
 
-        void get_drawing_range(PlayingField pfield, int &r1, int &r2, int &c1, int &c2);
-        void draw_to_pf(PlayingField pfield);
-        void draw_fill(PlayingField pfield);
-        void draw_frame(PlayingField pfield);
+        void get_drawing_range(PlayingField &pfield, int &r1, int &r2, int &c1, int &c2);
+        void draw_to_pf(PlayingField &pfield);
+        void draw_to_pf(PlayingField &pfield, CellBox clip);
+        void draw_fill(PlayingField &pfield);
+        void draw_frame(PlayingField &pfield);
 
         void set_draw_pattern(int pattern);
         void set_filler(char filler);
         Rect get_rect();
+        int get_color();
 
     private:
         Rect rect;
@@ -0,0 +1,62 @@
+#ifndef RENDER_TARGET_H_
+#define RENDER_TARGET_H_
+
+// Somewhere that the playing field is drawn to, one character cell at a time.
+// Rows and columns start at 0 in the top-left corner, as in an ncurses window.
+// Drawing outside the target is ignored.
+//
+// The game draws to a CursesTarget (an ncurses window). A FrameBuffer keeps the cells in memory instead,
+// so that drawing can be timed or checked without a terminal.
+class RenderTarget {
+    public:
+        virtual ~RenderTarget() {}
+
+        // Sets the color pair of everything drawn after this. Color pair 0 is the terminal's default colors.
+        // color_pair: The color pair.
+        virtual void set_color(int color_pair) = 0;
+
+        // Draws a character in a cell.
+        // r, c: The row and column of the cell.
+        // ch: The character.
+        virtual void put_char(int r, int c, char ch) = 0;
+
+        // Draws a string from a cell to the right.
+        // r, c: The row and column of the first character.
+        // str: The string.
+        virtual void put_string(int r, int c, const char *str) = 0;
+
+        // Draws a character in a number of cells from a cell to the right.
+        // r, c: The row and column of the first cell.
+        // ch: The character.
+        // count: The number of cells.
+        virtual void fill_row(int r, int c, char ch, int count) = 0;
+
+        // Draws a character in a number of cells from a cell downwards.
+        // r, c: The row and column of the first cell.
+        // ch: The character.
+        // count: The number of cells.
+        virtual void fill_column(int r, int c, char ch, int count) = 0;
+
+        // Draws a row of cells, each with its own character and color pair, from a cell to the right.
+        // The color set with set_color() is not changed.
+        // r, c: The row and column of the first cell.
+        // chars: The characters.
+        // colors: The color pairs.
+        // count: The number of cells.
+        virtual void put_cells(int r, int c, const char *chars, const int *colors, int count) = 0;
+
+        // Clears every cell.
+        virtual void clear() = 0;
+
+        // Shows what has been drawn since the last call, once a frame is complete. Targets that draw to the terminal
+        // also send the other ncurses windows staged with wnoutrefresh() during the frame, so that a frame is
+        // flushed to the terminal once.
+        virtual void present() = 0;
+
+        // Called before something else (e.g. a menu) is drawn over the target's part of the screen.
+        // Targets that send their cells to the terminal themselves hand the screen back to ncurses,
+        // and take it over again on the next present(). Does nothing by default.
+        virtual void release() {}
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "sim_input.h"
+#include "level.h"
+#include "ncu.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Returns the key that a script token stands for.
+// ".": Nothing pressed. "L": Left arrow. "R": Right arrow. "S": Space. "C": Fire missile.
+// token: The script token (without its repeat count).
+int script_token_to_key(std::string token) {
+    if (token == ".") {
+        return ERR;
+    }
+    if (token == "L") {
+        return KEY_LEFT;
+    }
+    if (token == "R") {
+        return KEY_RIGHT;
+    }
+    if (token == "S") {
+        return ' ';
+    }
+    if (token == "C") {
+        return 'c';
+    }
+    throw std::runtime_error("Unrecognized input script token: " + token);
+}
+
+// Returns the script token for a key. Keys that do nothing in the game become ".".
+// ch: The key pressed, or ERR if nothing was pressed.
+std::string key_to_script_token(int ch) {
+    if (ch == KEY_LEFT || ch == KEY_UP) {
+        return "L";
+    }
+    if (ch == KEY_RIGHT || ch == KEY_DOWN) {
+        return "R";
+    }
+    if (ch == ' ') {
+        return "S";
+    }
+    if (ch == 'c' || ch == 'C') {
+        return "C";
+    }
+    return ".";
+}
+
+// Constructs a scripted input from a string of whitespace-separated tokens, one per frame.
+// A token can be prefixed with a repeat count, e.g. "30*R S 5*L" holds right for 30 frames,
+// launches the ball, then holds left for 5 frames.
+// script: The script to play back.
+ScriptedInput::ScriptedInput(std::string script) {
+    std::istringstream ss(script);
+    std::string token;
+    while (ss >> token) {
+        int count = 1;
+        size_t star = token.find('*');
+        if (star != std::string::npos) {
+            count = std::stoi(token.substr(0, star));
+            token = token.substr(star + 1);
+        }
+        int key = script_token_to_key(token);
+        for (int i = 0; i < count; i++) {
+            keys.push_back(key);
+        }
+    }
+}
+
+// Returns the next key in the script.
+int ScriptedInput::next_key(Level &, bool) {
+    if (finished()) {
+        return ERR;
+    }
+    return keys[cur++];
+}
+
+// Returns if every key in the script has been played.
+bool ScriptedInput::finished() {
+    return cur >= (int)keys.size();
+}
+
+// Constructs a tracking player.
+// aim_frames: How many frames to wait before launching the ball.
+TrackingInput::TrackingInput(int aim_frames) {
+    TrackingInput::aim_frames = aim_frames;
+}
+
+// Launches the ball after waiting for a while, then chases the lowest ball with the paddle.
+// A missile is fired every 30 frames, which does nothing if the player has none.
+int TrackingInput::next_key(Level &level, bool aiming) {
+    ++frame;
+    if (aiming) {
+        if (++aimed >= aim_frames) {
+            aimed = 0;
+            return ' ';
+        }
+        return ERR;
+    }
+
+    if (frame % 30 == 0) {
+        return 'c';
+    }
+
+    Vector2 ball_pos;
+    if (!level.get_lowest_ball_pos(ball_pos)) {
+        return ERR;
+    }
+    double paddle_x = level.get_paddle_pos().x;
+    if (ball_pos.x < paddle_x - 0.5) {
+        return KEY_LEFT;
+    }
+    if (ball_pos.x > paddle_x + 0.5) {
+        return KEY_RIGHT;
+    }
+    return ERR;
+}
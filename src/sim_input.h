@@ -0,0 +1,46 @@
+#include "level.h"
+
+#include <string>
+#include <vector>
+
+#ifndef SIM_INPUT_H_
+#define SIM_INPUT_H_
+
+int script_token_to_key(std::string token);
+std::string key_to_script_token(int ch);
+
+// Decides which key is "pressed" on each frame of a headless simulation.
+class InputSource {
+    public:
+        virtual ~InputSource() {}
+
+        // Returns the key for the next frame, or ERR if nothing is pressed.
+        // level: The level being simulated.
+        // aiming: Whether the ball is still sitting on the paddle, waiting to be launched.
+        virtual int next_key(Level &level, bool aiming) = 0;
+};
+
+// Plays back a fixed sequence of keys, one per frame.
+// Once the script runs out, nothing is pressed.
+class ScriptedInput : public InputSource {
+    public:
+        ScriptedInput(std::string script);
+        int next_key(Level &level, bool aiming);
+        bool finished();
+
+    private:
+        std::vector<int> keys;
+        int cur = 0;
+};
+
+// A simple player that keeps the paddle under the lowest ball and fires missiles whenever it can.
+class TrackingInput : public InputSource {
+    public:
+        TrackingInput(int aim_frames = 10);
+        int next_key(Level &level, bool aiming);
+
+    private:
+        int aim_frames, aimed = 0, frame = 0;
+};
+
+#endif
@@ -0,0 +1,201 @@
+#include "frame_buffer.h"
+#include "input_recorder.h"
+#include "math_utils.h"
+#include "sim_input.h"
+#include "simulation.h"
+#include "trace.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Prints how to use the simulator.
+void print_usage() {
+    std::cerr << "Usage: sim <level.bl> [-n runs] [-f max_frames] [-s script_file] [--seed n] [--trace file]" << std::endl;
+    std::cerr << "           [--frame file] [--golden file] [--low-detail]" << std::endl;
+    std::cerr << "       sim --replay <recording>" << std::endl;
+    std::cerr << "Without a script, the paddle follows the lowest ball." << std::endl;
+    std::cerr << "Run i is played with a seed derived from n and i (n is 1 by default)." << std::endl;
+    std::cerr << "--trace writes the phases of every frame and what happened in the game to a trace file." << std::endl;
+    std::cerr << "--frame draws every frame into memory and writes the last frame of the last run to a file." << std::endl;
+    std::cerr << "--golden draws every frame into memory and checks that the last frame of each run matches a file" << std::endl;
+    std::cerr << "written by --frame. sim exits with 1 if it does not." << std::endl;
+    std::cerr << "--low-detail draws the playing field with reduced detail, as on a slow terminal." << std::endl;
+}
+
+// Reads a whole file into a string. Throws a runtime error if the file cannot be opened.
+// filename: The address of the file to read.
+std::string read_file(std::string filename) {
+    std::ifstream fin(filename);
+    if (fin.fail()) {
+        throw std::runtime_error("Failed to open " + filename);
+    }
+    std::stringstream ss;
+    ss << fin.rdbuf();
+    return ss.str();
+}
+
+// Replays every game in a recording made with "main --record", and checks that each level ends
+// on the same frame with the same score as when it was recorded.
+// Returns 0 if every level matches, 1 otherwise.
+// filename: The address of the recording.
+int replay(std::string filename) {
+    std::vector<RecordedGame> games = read_recording(filename);
+    int mismatches = 0;
+
+    for (size_t g = 0; g < games.size(); g++) {
+        Simulation sim;
+        sim.set_seed(games[g].seed);
+
+        for (RecordedLevel &recorded : games[g].levels) {
+            ScriptedInput scripted(recorded.script);
+            sim.set_input(scripted);
+            if (sim.load_level(recorded.level_file) != 0) {
+                std::cerr << "Failed to load " << recorded.level_file << std::endl;
+                return 1;
+            }
+            while (!scripted.finished() && sim.step()) {
+                continue;
+            }
+
+            bool match = recorded.frames < 0 ||
+                         (sim.get_frames() == recorded.frames && sim.get_stat().get_score() == recorded.score);
+            if (!match) {
+                ++mismatches;
+            }
+            std::cout << "game " << g
+                      << " level " << recorded.level_file
+                      << " frames " << sim.get_frames()
+                      << " score " << sim.get_stat().get_score()
+                      << " recorded_frames " << recorded.frames
+                      << " recorded_score " << recorded.score
+                      << " match " << (match ? 1 : 0) << std::endl;
+        }
+    }
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Plays a level headlessly, as fast as possible, and prints the outcome of each run.
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+
+    if (std::string(argv[1]) == "--replay") {
+        if (argc != 3) {
+            print_usage();
+            return 1;
+        }
+        return replay(argv[2]);
+    }
+
+    std::string level_file = argv[1];
+    std::string script;
+    bool has_script = false;
+    int runs = 1, max_frames = 100000;
+    unsigned int seed = 1;
+    std::string trace_file = "";
+    std::string frame_file = "";
+    std::string golden_file = "";
+    bool low_detail = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--low-detail") {
+            low_detail = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            print_usage();
+            return 1;
+        }
+        if (arg == "-n") {
+            runs = std::atoi(argv[++i]);
+        } else if (arg == "-f") {
+            max_frames = std::atoi(argv[++i]);
+        } else if (arg == "-s") {
+            script = read_file(argv[++i]);
+            has_script = true;
+        } else if (arg == "--seed") {
+            seed = (unsigned int)std::strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--trace") {
+            trace_file = argv[++i];
+        } else if (arg == "--frame") {
+            frame_file = argv[++i];
+        } else if (arg == "--golden") {
+            golden_file = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (trace_file != "") {
+        start_tracing();
+        name_trace_thread("sim");
+    }
+
+    long long total_frames = 0;
+    bool frames_match = true;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int run = 0; run < runs; run++) {
+        TraceSpan span("run", "sim");
+        Simulation sim;
+        sim.set_seed(derive_seed(seed, run));
+        FrameBuffer frame(sim.get_playing_field().max_y, sim.get_playing_field().max_x);
+        if (frame_file != "" || golden_file != "") {
+            sim.set_render_target(frame);
+        }
+        sim.get_playing_field().set_reduced_detail(low_detail);
+        ScriptedInput scripted(script);
+        TrackingInput tracking;
+        if (has_script) {
+            sim.set_input(scripted);
+        } else {
+            sim.set_input(tracking);
+        }
+
+        if (sim.load_level(level_file) != 0) {
+            std::cerr << "Failed to load " << level_file << std::endl;
+            return 1;
+        }
+        sim.run(max_frames);
+        total_frames += sim.get_frames();
+
+        std::cout << "run " << run
+                  << " frames " << sim.get_frames()
+                  << " cleared " << (sim.level_cleared() ? 1 : 0)
+                  << " score " << sim.get_stat().get_score()
+                  << " lives " << sim.get_stat().get_lives()
+                  << " peak_balls " << sim.get_level().get_peak_balls()
+                  << " peak_drops " << sim.get_level().get_peak_power_up_drops()
+                  << " peak_missiles " << sim.get_level().get_peak_missiles() << std::endl;
+
+        if (frame_file != "") {
+            frame.save(frame_file);
+        }
+        if (golden_file != "") {
+            int line = frame.compare_to_file(golden_file);
+            if (line != 0) {
+                std::cout << "run " << run << " frame differs from " << golden_file << " at line " << line << std::endl;
+                frames_match = false;
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "total_frames " << total_frames
+              << " seconds " << seconds
+              << " frames_per_second " << (seconds > 0 ? total_frames / seconds : 0) << std::endl;
+
+    if (trace_file != "") {
+        write_trace(trace_file);
+    }
+    return frames_match ? 0 : 1;
+}
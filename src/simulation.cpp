@@ -0,0 +1,147 @@
+#include "simulation.h"
+#include "game_stat.h"
+#include "level.h"
+#include "math_utils.h"
+#include "sim_input.h"
+
+#include <string>
+
+// Constructs a simulation with no level loaded.
+Simulation::Simulation() {
+    pf.set_display_window();
+    bar.set_display_window(pf.max_y + 6);
+}
+
+// Frees the level being simulated, if any.
+Simulation::~Simulation() {
+    if (level != NULL) {
+        level->destroy_objects();
+        delete level;
+    }
+}
+
+// Loads a level from a .bl file. Returns 0 if the level is successfully loaded, 1 otherwise.
+// Loading another level after the first one carries on the same game, like moving on to the next level in Game.
+// filename: The address of the level file to load.
+int Simulation::load_level(std::string filename) {
+    if (level != NULL) {
+        level->destroy_objects();
+        delete level;
+
+        game_stat.reset_lv_stats();
+        game_stat.reset_timer();
+        bar.reset();
+    }
+
+    level = new Level();
+    level->bind_stat(game_stat);
+    level->bind_playing_field(pf);
+    level->bind_notification_bar(bar);
+    level->set_seed(derive_seed(seed, levels_loaded++));
+    game_stat.add_level();
+
+    aiming = true;
+    frames = 0;
+    return level->load_level_by_file(filename);
+}
+
+// Sets where the keys of each frame come from.
+// input: The input source. It must outlive the simulation.
+void Simulation::set_input(InputSource &input) {
+    Simulation::input = &input;
+}
+
+// Sets the seed of the game. It should be set before the first level is loaded.
+// seed: The seed, e.g. one saved in a recording.
+void Simulation::set_seed(unsigned int seed) {
+    Simulation::seed = seed;
+}
+
+// Draws every frame from now on, in the same way as the game draws to the terminal.
+// target: The target to draw to, e.g. a FrameBuffer the size of the playing field. It must outlive the simulation.
+void Simulation::set_render_target(RenderTarget &target) {
+    pf.set_render_target(target);
+    rendering = true;
+}
+
+// Simulates one frame. Returns false once the level has ended, either cleared or out of lives.
+bool Simulation::step() {
+    if (level == NULL || input == NULL || ended()) {
+        return false;
+    }
+
+    int ch = input->next_key(*level, aiming);
+    if (aiming) {
+        level->aim_ball(ch);
+        if (ch == ' ') {
+            aiming = false;
+        }
+    } else {
+        level->simulate_frame(ch);
+        if (!level->has_ball() || level->all_bricks_destroyed()) {
+            end_round();
+        }
+    }
+
+    if (rendering) {
+        level->render_screen();
+    }
+
+    ++frames;
+    return !ended();
+}
+
+// Simulates until the level ends or a frame limit is reached. Returns the number of frames simulated.
+// max_frames: The frame limit.
+int Simulation::run(int max_frames) {
+    int start = frames;
+    while (frames - start < max_frames && step()) {
+        continue;
+    }
+    return frames - start;
+}
+
+// Handles the end of a round in the same way as Game::run_round.
+void Simulation::end_round() {
+    if (!level->has_ball()) {
+        game_stat.sub_lives();
+    }
+
+    if (game_stat.has_lives() && !level->all_bricks_destroyed()) {
+        level->reset_level();
+        game_stat.reset_lv_stats();
+        game_stat.reset_timer();
+        bar.reset();
+        aiming = true;
+    }
+}
+
+// Returns if every breakable brick in the level has been destroyed.
+bool Simulation::level_cleared() {
+    return level != NULL && level->all_bricks_destroyed();
+}
+
+// Returns if the level has ended, either because it was cleared or because the player ran out of lives.
+bool Simulation::ended() {
+    return level_cleared() || !game_stat.has_lives();
+}
+
+// Returns the number of frames simulated since the level was loaded.
+int Simulation::get_frames() {
+    return frames;
+}
+
+// Returns the level being simulated. A level must have been loaded.
+Level &Simulation::get_level() {
+    return *level;
+}
+
+// Returns the playing field that the levels are played on.
+PlayingField &Simulation::get_playing_field() {
+    return pf;
+}
+
+// Returns the game statistics of the simulation.
+GameStat &Simulation::get_stat() {
+    return game_stat;
+}
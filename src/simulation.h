@@ -0,0 +1,55 @@
+#include "game_stat.h"
+#include "level.h"
+#include "notification_bar.h"
+#include "playing_field.h"
+#include "render_target.h"
+#include "sim_input.h"
+
+#include <string>
+
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+// Plays a level without a terminal: no window, no waiting between frames and, unless a render target is set,
+// nothing drawn. Follows the same rules as Game (lives, rounds, relaunching the ball), but takes its keys from an InputSource.
+class Simulation {
+    public:
+        Simulation();
+        ~Simulation();
+
+        int load_level(std::string filename);
+        void set_input(InputSource &input);
+        void set_seed(unsigned int seed);
+        void set_render_target(RenderTarget &target);
+
+        bool step();
+        int run(int max_frames);
+
+        bool level_cleared();
+        bool ended();
+        int get_frames();
+        GameStat &get_stat();
+        Level &get_level();
+        PlayingField &get_playing_field();
+
+    private:
+        PlayingField pf = PlayingField({32.0, 32.0});
+        NotificationBar bar = NotificationBar(64, 1);
+        GameStat game_stat;
+        Level *level = NULL;
+        InputSource *input = NULL;
+
+        // Whether the ball is sitting on the paddle, waiting to be launched.
+        bool aiming = true;
+        int frames = 0;
+        // Whether every frame is drawn to the render target.
+        bool rendering = false;
+
+        // Each level draws its random numbers from a seed derived from this one, in the same way as Game.
+        unsigned int seed = 0;
+        int levels_loaded = 0;
+
+        void end_round();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include <atomic>
+#include <cstddef>
+
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+// A fixed-size queue for passing values from one thread (the producer) to one other thread (the consumer)
+// without locks. Only the producer may call push() and only the consumer may call pop().
+// Capacity must be a power of two; the queue holds up to Capacity values.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    public:
+        bool push(const T &value);
+        bool pop(T &value);
+
+    private:
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+        T slots[Capacity];
+        // Counts of values pushed and popped so far. Each is written by one thread only.
+        std::atomic<size_t> pushed{0}, popped{0};
+};
+
+// Adds a value to the back of the queue. Returns false, dropping the value, if the queue is full.
+// Only the producer thread may call this.
+// value: The value to add.
+template <typename T, size_t Capacity>
+bool SpscQueue<T, Capacity>::push(const T &value) {
+    size_t back = pushed.load(std::memory_order_relaxed);
+    if (back - popped.load(std::memory_order_acquire) == Capacity) {
+        return false;
+    }
+    slots[back & (Capacity - 1)] = value;
+    pushed.store(back + 1, std::memory_order_release);
+    return true;
+}
+
+// Takes the value at the front of the queue. Returns false if the queue is empty.
+// Only the consumer thread may call this.
+// &value: Set to the value taken.
+template <typename T, size_t Capacity>
+bool SpscQueue<T, Capacity>::pop(T &value) {
+    size_t front = popped.load(std::memory_order_relaxed);
+    if (front == pushed.load(std::memory_order_acquire)) {
+        return false;
+    }
+    value = slots[front & (Capacity - 1)];
+    popped.store(front + 1, std::memory_order_release);
+    return true;
+}
+
+#endif
@@ -0,0 +1,226 @@
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// One recorded span or instant event. Names and categories must be string literals; other text is copied.
+struct TraceEvent {
+    const char *name;
+    const char *category;
+    // 'X' for a span and 'i' for an instant event, as in the trace-event format.
+    char phase;
+    // Since tracing started, in nanoseconds.
+    long long start_ns, duration_ns;
+    // An optional number (arg_name is NULL if there is none) and text to show with the event.
+    const char *arg_name;
+    long long arg_value;
+    char text[48];
+};
+
+// The events recorded by one thread.
+struct ThreadTrace {
+    int tid;
+    std::string thread_name;
+    // A deque does not move its events when it grows, so recording never copies old events.
+    std::deque<TraceEvent> events;
+};
+
+std::atomic<bool> tracing_enabled{false};
+
+namespace {
+
+std::chrono::steady_clock::time_point trace_start;
+
+// Every thread's buffer. They are kept until the program ends, so that threads can stop before the trace is written.
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadTrace>> registry;
+
+thread_local ThreadTrace *local_trace = NULL;
+
+// Returns the buffer of the calling thread, creating it when the thread records its first event.
+ThreadTrace &get_local_trace() {
+    if (local_trace == NULL) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.emplace_back(new ThreadTrace());
+        local_trace = registry.back().get();
+        local_trace->tid = registry.size();
+        local_trace->thread_name = "thread " + std::to_string(local_trace->tid);
+    }
+    return *local_trace;
+}
+
+// Adds an event to the calling thread's buffer.
+// event: The event. Its text is set from text.
+// text: The text to show with the event, or NULL. It is cut short if it is too long.
+void record(TraceEvent &event, const char *text) {
+    if (text != NULL) {
+        std::strncpy(event.text, text, sizeof(event.text) - 1);
+        event.text[sizeof(event.text) - 1] = '\0';
+    } else {
+        event.text[0] = '\0';
+    }
+    get_local_trace().events.push_back(event);
+}
+
+// Writes a string as a JSON string, with quotes.
+// fout: The stream to write to.
+// str: The string.
+void write_json_string(std::ofstream &fout, const char *str) {
+    fout << '"';
+    for (; *str != '\0'; str++) {
+        unsigned char c = *str;
+        if (c == '"' || c == '\\') {
+            fout << '\\' << c;
+        } else if (c < 0x20) {
+            const char *hex = "0123456789abcdef";
+            fout << "\\u00" << hex[c >> 4] << hex[c & 15];
+        } else {
+            fout << c;
+        }
+    }
+    fout << '"';
+}
+
+} // namespace
+
+// Starts recording events. The timestamps in the trace count from this call.
+void start_tracing() {
+    trace_start = std::chrono::steady_clock::now();
+    tracing_enabled = true;
+}
+
+// Names the calling thread in the trace.
+// name: The name.
+void name_trace_thread(const char *name) {
+    if (is_tracing()) {
+        get_local_trace().thread_name = name;
+    }
+}
+
+// Records an instant event on the calling thread, if events are being recorded.
+// name: The name of the event. It must be a string literal.
+// category: The category of the event, e.g. "game". It must be a string literal.
+// arg_name: The name of a number to show with the event (a string literal), or NULL.
+// arg_value: The number.
+// text: Text to show with the event, or NULL.
+void trace_instant(const char *name, const char *category, const char *arg_name, long long arg_value,
+                   const char *text) {
+    if (!is_tracing()) {
+        return;
+    }
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'i';
+    event.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - trace_start).count();
+    event.duration_ns = 0;
+    event.arg_name = arg_name;
+    event.arg_value = arg_value;
+    record(event, text);
+}
+
+// Records a span that has ended on the calling thread, if events are being recorded.
+// name: The name of the span. It must be a string literal.
+// category: The category of the span, e.g. "frame". It must be a string literal.
+// start: When the span started.
+// duration: How long the span took.
+// text: Text to show with the span, or NULL.
+void trace_span(const char *name, const char *category, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::duration duration, const char *text) {
+    if (!is_tracing()) {
+        return;
+    }
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'X';
+    event.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start - trace_start).count();
+    event.duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    event.arg_name = NULL;
+    event.arg_value = 0;
+    record(event, text);
+}
+
+// Writes every event recorded so far to a file in the Chrome trace-event JSON format.
+// Every thread other than the calling one must have stopped recording. Throws a runtime error if the file cannot be written.
+// filename: The address of the file. It is overwritten.
+void write_trace(std::string filename) {
+    std::ofstream fout(filename);
+    if (fout.fail()) {
+        throw std::runtime_error("Failed to open " + filename + " for writing the trace.");
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    fout << std::fixed << std::setprecision(3);
+    fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const std::unique_ptr<ThreadTrace> &thread : registry) {
+        fout << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->tid
+             << ",\"args\":{\"name\":";
+        write_json_string(fout, thread->thread_name.c_str());
+        fout << "}}";
+        first = false;
+
+        for (const TraceEvent &event : thread->events) {
+            fout << ",\n{\"name\":";
+            write_json_string(fout, event.name);
+            fout << ",\"cat\":";
+            write_json_string(fout, event.category);
+            // Times are in microseconds
+            fout << ",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << thread->tid << ",\"ts\":"
+                 << event.start_ns / 1000.0;
+            if (event.phase == 'X') {
+                fout << ",\"dur\":" << event.duration_ns / 1000.0;
+            } else {
+                fout << ",\"s\":\"t\"";
+            }
+            if (event.arg_name != NULL || event.text[0] != '\0') {
+                fout << ",\"args\":{";
+                if (event.arg_name != NULL) {
+                    write_json_string(fout, event.arg_name);
+                    fout << ":" << event.arg_value;
+                }
+                if (event.text[0] != '\0') {
+                    fout << (event.arg_name != NULL ? "," : "") << "\"detail\":";
+                    write_json_string(fout, event.text);
+                }
+                fout << "}";
+            }
+            fout << "}";
+        }
+    }
+    fout << "\n]}\n";
+    if (fout.fail()) {
+        throw std::runtime_error("Failed to write the trace to " + filename + ".");
+    }
+}
+
+// Starts a span.
+// name: The name of the span. It must be a string literal.
+// category: The category of the span. It must be a string literal.
+// text: Text to show with the span, or NULL.
+TraceSpan::TraceSpan(const char *name, const char *category, const char *text) : name(name), category(category) {
+    traced = is_tracing();
+    if (traced) {
+        if (text != NULL) {
+            TraceSpan::text = text;
+        }
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+// Ends the span and records it.
+TraceSpan::~TraceSpan() {
+    if (traced) {
+        trace_span(name, category, start, std::chrono::steady_clock::now() - start, text.empty() ? NULL : text.c_str());
+    }
+}
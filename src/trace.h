@@ -0,0 +1,50 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+// Records what happened during a session as spans (things that took time, e.g. a frame or the pause menu)
+// and instant events (e.g. a brick broken), to be written as a Chrome trace-event JSON file and opened in
+// a trace viewer such as chrome://tracing or Perfetto.
+//
+// Each thread records into a buffer of its own, so recording takes no locks; the only lock is taken when a
+// thread records its first event. The buffers are only read by write_trace(), after every other thread that
+// recorded has stopped. Nothing is recorded until start_tracing() is called.
+
+// Whether events are being recorded. Use is_tracing() to read it.
+extern std::atomic<bool> tracing_enabled;
+
+void start_tracing();
+void name_trace_thread(const char *name);
+void trace_instant(const char *name, const char *category, const char *arg_name = NULL, long long arg_value = 0,
+                   const char *text = NULL);
+void trace_span(const char *name, const char *category, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::duration duration, const char *text = NULL);
+void write_trace(std::string filename);
+
+// Returns if events are being recorded.
+inline bool is_tracing() {
+    return tracing_enabled.load(std::memory_order_relaxed);
+}
+
+// Records a span from its construction to the end of its scope, if events are being recorded.
+class TraceSpan {
+    public:
+        TraceSpan(const char *name, const char *category, const char *text = NULL);
+        ~TraceSpan();
+
+    private:
+        const char *name, *category;
+        // Copied, so that the span can outlive the string it was given.
+        std::string text;
+        bool traced;
+        std::chrono::steady_clock::time_point start;
+
+        // A span records itself once, so it cannot be copied.
+        TraceSpan(const TraceSpan &);
+        TraceSpan &operator=(const TraceSpan &);
+};
+
+#endif
@@ -14,6 +14,8 @@ Well::Well(Rect rect) {
     initialize_walls(rect);
     inner_box = {rect.bottom_left().add_x(margin), rect.top_right().add_x(-margin)};
     shield_box = {rect.bottom_left().add_y(-margin), rect.bottom_right().add_y(margin)};
+    shield_wall = RectWall(shield_box);
+    shield_wall.set_draw_pattern(1);
 }
 
 // Initializes the top, left and right walls.
@@ -42,21 +44,30 @@ bool Well::is_below_well(double y) {
     return y < get_inner_box().pos1.y - 0.5;
 }
 
-// Displays the well on the screen.
+// Draws the top, left and right walls, which never change during a level.
 // pf: The playing field to draw on.
-void Well::draw(PlayingField pf) {
-    for (RectWall wall : walls) {
+void Well::draw_walls(PlayingField &pf) {
+    for (RectWall &wall : walls) {
         wall.draw_to_pf(pf);
     }
+}
 
-    RectWall shield_wall(shield_box);
-    shield_wall.set_draw_pattern(1);
+// Draws the shield along the bottom of the well, with the filler of its current level.
+// pf: The playing field to draw on.
+void Well::draw_shield(PlayingField &pf) {
     shield_wall.set_filler(shield.get_filler());
     shield_wall.draw_to_pf(pf);
-    wrefresh(pf.get_display_window());
+}
+
+// Draws the part of the shield that lies inside the given cells.
+// pf: The playing field to draw on.
+// clip: The cells to draw in.
+void Well::draw_shield(PlayingField &pf, CellBox clip) {
+    shield_wall.set_filler(shield.get_filler());
+    shield_wall.draw_to_pf(pf, clip);
 }
 
 // Returns the walls that form the well (one on the top, one on the left and one of the right).
-std::vector<RectWall> Well::get_walls() {
+const std::vector<RectWall> &Well::get_walls() {
     return walls;
 }
\ No newline at end of file
@@ -12,10 +12,12 @@
 class Well {
     public:
         Well(Rect rect);
-        std::vector<RectWall> get_walls();
+        const std::vector<RectWall> &get_walls();
         Rect get_inner_box();
         bool is_below_well(double y);
-        void draw(PlayingField pf);
+        void draw_walls(PlayingField &pf);
+        void draw_shield(PlayingField &pf);
+        void draw_shield(PlayingField &pf, CellBox clip);
         Shield shield;
 
     private:
@@ -23,6 +25,8 @@ class Well {
         // It is in the order of top, left and right.
         std::vector<RectWall> walls;
         Rect shield_box;
+        // The shield is drawn as a wall along the bottom of the well, with the filler of its level.
+        RectWall shield_wall = RectWall(Rect());
         Rect inner_box;
 
         void initialize_walls(Rect rect);